@@ -0,0 +1,602 @@
+// dear imgui: headless software rasterizer regression and benchmark harness
+// (render scripted frames with imgui_impl_raster into memory, compare them against reference images, report throughput)
+//
+// Usage: example_null_raster [options] [scene...]
+//   --update        write the reference images instead of comparing against them, to re-baseline after an intended change
+//   --ref DIR       directory of the reference images (default: the stored example_null_raster/reference)
+//   --threads N     ImGuiImplRasterinfo::threads (default: 0)
+//   --frames N      timed frames per scene (default: 60)
+//   --tolerance N   largest accepted per channel difference (default: 2)
+//   --max-bad F     largest accepted fraction of pixels over the tolerance (default: 0.001)
+//   --occlusion     ImGuiImplRasterFlags_OcclusionCulling, with opaque window backgrounds: instead of the references, the frame
+//                   must match the same scene rendered unculled exactly, both serial and threaded (4 threads if --threads is 0)
+//   --layers        ImGuiImplRasterFlags_LayerCache (within the default tolerance of the references)
+//   --record DIR    stream the frames of each scene to DIR/<scene>.y4m with ImGui_ImplRaster_BeginStream()
+//   --shm NAME      render with dirty rectangles into the shared memory ring NAME (see example_shm_reader)
+//   --stats         ImGuiImplRasterFlags_Stats, print the counters of the compared frame
+//   --linear        ImGuiImplRasterFlags_LinearBlending, to time against the default blend (use its own references)
+//   --polyline N    instead of the scenes, time the anti-aliased ImDrawList::AddPolyline() tessellation of N point lines (Mpoints/s),
+//                   as they are and with ImDrawListFlags_DecimateLines
+// Scenes are all run when none is named. Exits with 1 if a scene does not match its reference.
+// The references are stored in the repository, the output is the same for any kernel and thread count.
+// On a mismatch the rendered frame is written next to the reference as <scene>.out.ppm.
+// Mpixels/s counts the pixels of the whole target, Mtriangles/s the triangles of the draw data.
+#include "imgui.h"
+#include "imgui_impl_raster.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+// The CMake build sets the stored references of the source tree, so it runs from any directory
+#ifndef IMGUI_NULL_RASTER_REFERENCE
+#define IMGUI_NULL_RASTER_REFERENCE "reference"
+#endif
+
+static const int WIDTH = 1280;
+static const int HEIGHT = 720;
+static const int WARMUP_FRAMES = 10;    // let windows auto-size and fade in before timing and comparing
+
+//-----------------------------------------------------------------------------
+// Scenes
+//-----------------------------------------------------------------------------
+// Each scene is run in a fresh ImGui context with fixed time steps and no input, so
+// every run produces the same frames.
+
+static void SceneDemo(int frame)
+{
+    ImGui::SetNextWindowPos(ImVec2(20, 20));
+    ImGui::SetNextWindowSize(ImVec2(560, 680));
+    ImGui::ShowDemoWindow();
+
+    ImGui::SetNextWindowPos(ImVec2(600, 20));
+    ImGui::SetNextWindowSize(ImVec2(660, 680));
+    ImGui::Begin("Style Editor");
+    ImGui::ShowStyleEditor();
+    ImGui::End();
+    (void)frame;
+}
+
+static void SceneText(int frame)
+{
+    ImGui::SetNextWindowPos(ImVec2(0, 0));
+    ImGui::SetNextWindowSize(ImVec2((float)WIDTH, (float)HEIGHT));
+    ImGui::Begin("Table", NULL, ImGuiWindowFlags_NoTitleBar);
+    ImGui::Columns(6, "table");
+    ImGui::Separator();
+    const char* names[6] = { "ID", "Name", "Path", "Size", "Flags", "Hash" };
+    for (int i = 0; i < 6; i++)
+    {
+        ImGui::Text("%s", names[i]);
+        ImGui::NextColumn();
+    }
+    ImGui::Separator();
+    for (int row = 0; row < 40; row++)
+    {
+        const int n = row + frame;
+        ImGui::Text("%04d", n);
+        ImGui::NextColumn();
+        ImGui::Text("Item %d of the list", n);
+        ImGui::NextColumn();
+        ImGui::Text("/usr/share/data/%c%c%c/file_%d.bin", 'a' + n % 26, 'a' + n * 7 % 26, 'a' + n * 13 % 26, n);
+        ImGui::NextColumn();
+        ImGui::Text("%d.%02d KB", n * 37 % 1000, n % 100);
+        ImGui::NextColumn();
+        ImGui::TextColored(ImVec4(1.0f, 0.5f + 0.5f * (n % 2), 0.2f, 1.0f), "%s", (n % 3) ? "rw-r--r--" : "rwxr-xr-x");
+        ImGui::NextColumn();
+        ImGui::Text("%08x%08x", n * 2654435761u, n * 40503u);
+        ImGui::NextColumn();
+    }
+    ImGui::Columns(1);
+    ImGui::End();
+}
+
+static void ScenePlots(int frame)
+{
+    static float values[1000];
+    for (int i = 0; i < IM_ARRAYSIZE(values); i++)
+        values[i] = sinf(i * 0.02f + frame * 0.1f) * cosf(i * 0.005f);
+
+    ImGui::SetNextWindowPos(ImVec2(0, 0));
+    ImGui::SetNextWindowSize(ImVec2(820, (float)HEIGHT));
+    ImGui::Begin("Plots");
+    for (int i = 0; i < 4; i++)
+    {
+        ImGui::PushID(i);
+        ImGui::PlotLines("lines", values + i * 100, 600, 0, NULL, -1.0f, 1.0f, ImVec2(760, 70));
+        ImGui::PlotHistogram("histogram", values + i * 50, 300, 0, NULL, -1.0f, 1.0f, ImVec2(760, 70));
+        ImGui::PopID();
+    }
+    ImGui::End();
+
+    // Gradients: hue bars and saturation/value squares
+    ImGui::SetNextWindowPos(ImVec2(830, 0));
+    ImGui::SetNextWindowSize(ImVec2(450, (float)HEIGHT));
+    ImGui::Begin("Colors");
+    static float color[4] = { 0.4f, 0.7f, 0.0f, 0.5f };
+    ImGui::ColorPicker4("picker", color, ImGuiColorEditFlags_AlphaBar);
+    ImGui::ColorPicker4("wheel", color, ImGuiColorEditFlags_PickerHueWheel | ImGuiColorEditFlags_NoInputs);
+    ImGui::End();
+}
+
+static void ScenePopups(int frame)
+{
+    for (int i = 0; i < 6; i++)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "Window %d", i);
+        ImGui::SetNextWindowPos(ImVec2(40.0f + i * 130.0f, 40.0f + i * 70.0f));
+        ImGui::SetNextWindowSize(ImVec2(420, 300));
+        ImGui::SetNextWindowBgAlpha(0.35f + 0.1f * i);
+        ImGui::Begin(name);
+        ImGui::TextWrapped("Translucent window %d, drawn over the previous ones. Frame %d.", i, frame);
+        ImGui::Button("Button");
+        ImGui::ProgressBar((frame % 60) / 60.0f);
+        ImGui::End();
+    }
+
+    // A modal dims everything behind it with a full screen translucent rectangle
+    ImGui::OpenPopup("Modal");
+    ImGui::SetNextWindowPos(ImVec2(700, 420));
+    if (ImGui::BeginPopupModal("Modal", NULL, ImGuiWindowFlags_AlwaysAutoResize))
+    {
+        ImGui::Text("Modal popup over translucent windows");
+        ImGui::Separator();
+        ImGui::Button("OK", ImVec2(120, 0));
+
+        ImGui::SetNextWindowPos(ImVec2(900, 520));
+        ImGui::BeginTooltip();
+        ImGui::Text("Tooltip over the modal");
+        ImGui::EndTooltip();
+        ImGui::EndPopup();
+    }
+}
+
+// A dense grid of cells in one draw list, well over the 64K vertices 16-bit indices can address
+// (ImDrawCmd::VtxOffset splits it in several commands). Submitted with ImDrawList::AddRectsFilled().
+static void SceneGrid(int frame)
+{
+    const int columns = 240, rows = 128;
+    const float cell = 5.0f;
+    static ImVec2 p_min[columns * rows], p_max[columns * rows];
+    static ImU32 colors[columns * rows];
+    ImGui::SetNextWindowPos(ImVec2(0, 0));
+    ImGui::SetNextWindowSize(ImVec2((float)WIDTH, (float)HEIGHT));
+    ImGui::Begin("Grid");
+    ImGui::Text("%d cells, frame %d", columns * rows, frame);
+    const ImVec2 origin = ImGui::GetCursorScreenPos();
+    for (int y = 0; y < rows; y++)
+        for (int x = 0; x < columns; x++)
+        {
+            const int i = y * columns + x;
+            const float v = sinf(x * 0.07f + frame * 0.05f) * cosf(y * 0.11f - frame * 0.03f);
+            colors[i] = v > 0.0f ? IM_COL32(40, 80 + (int)(v * 175), 40, 255) : IM_COL32(80 - (int)(v * 175), 40, 40, 255);
+            p_min[i] = ImVec2(origin.x + x * cell, origin.y + y * cell);
+            p_max[i] = ImVec2(p_min[i].x + cell - 1.0f, p_min[i].y + cell - 1.0f);
+        }
+    ImGui::GetWindowDrawList()->AddRectsFilled(p_min, p_max, colors, columns * rows);
+    ImGui::End();
+}
+
+// A large static diagram recorded once with ImDrawListCache and replayed in the following frames, translated
+// along with its moving window. It is recorded again when its highlighted node (and so its content hash) changes.
+static void SceneDiagram(int frame)
+{
+    const int columns = 40, rows = 24;
+    const float spacing = 24.0f;
+    static ImDrawListCache cache;
+    if (frame == 0)
+        cache.ClearFreeMemory();
+    ImGui::SetNextWindowPos(ImVec2(20.0f + (frame % 50) * 4.0f, 20.0f));
+    ImGui::SetNextWindowSize(ImVec2(1000, 660));
+    ImGui::Begin("Diagram");
+    ImGui::Text("%d nodes, frame %d", columns * rows, frame);
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    const ImVec2 origin = ImGui::GetCursorScreenPos();
+    const ImGuiID id = ImGui::GetID("diagram");
+    const int highlighted = (frame / 20) % (columns * rows);
+    if (!cache.Replay(draw_list, id, (ImU32)highlighted, origin))
+    {
+        cache.BeginRecord(draw_list, id, (ImU32)highlighted, origin);
+        for (int y = 0; y < rows; y++)
+            for (int x = 0; x < columns; x++)
+            {
+                const ImVec2 center(origin.x + (x + 0.5f) * spacing, origin.y + (y + 0.5f) * spacing);
+                if (x + 1 < columns)
+                    draw_list->AddLine(center, ImVec2(center.x + spacing, center.y + ((x + y) % 3 - 1) * 4.0f), IM_COL32(120, 120, 160, 255));
+                if (y + 1 < rows)
+                    draw_list->AddLine(center, ImVec2(center.x, center.y + spacing), IM_COL32(120, 160, 120, 255));
+                const int i = y * columns + x;
+                draw_list->AddCircleFilled(center, 7.0f, i == highlighted ? IM_COL32(255, 220, 64, 255) : IM_COL32(60, 90 + (i * 37) % 120, 160, 255));
+                if (i % 7 == 0)
+                {
+                    char label[8];
+                    snprintf(label, IM_ARRAYSIZE(label), "%d", i);
+                    draw_list->AddText(ImVec2(center.x - 6.0f, center.y - 6.0f), IM_COL32_WHITE, label);
+                }
+            }
+        cache.EndRecord(draw_list);
+    }
+    ImGui::Dummy(ImVec2(columns * spacing, rows * spacing));
+    ImGui::End();
+}
+
+struct Scene
+{
+    const char* Name;
+    void        (*Draw)(int frame);
+};
+
+static const Scene g_Scenes[] =
+{
+    { "demo",    SceneDemo },
+    { "text",    SceneText },
+    { "plots",   ScenePlots },
+    { "popups",  ScenePopups },
+    { "grid",    SceneGrid },
+    { "diagram", SceneDiagram },
+};
+
+//-----------------------------------------------------------------------------
+// Images
+//-----------------------------------------------------------------------------
+
+// Binary PPM (P6), RGB
+static bool WritePPM(const std::string& path, const std::vector<uint32_t>& pixels)
+{
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f)
+        return false;
+    fprintf(f, "P6\n%d %d\n255\n", WIDTH, HEIGHT);
+    std::vector<unsigned char> row(WIDTH * 3);
+    for (int y = 0; y < HEIGHT; y++)
+    {
+        for (int x = 0; x < WIDTH; x++)
+        {
+            const uint32_t c = pixels[y * WIDTH + x];
+            row[x * 3 + 0] = (unsigned char)(c >> 16);
+            row[x * 3 + 1] = (unsigned char)(c >> 8);
+            row[x * 3 + 2] = (unsigned char)(c);
+        }
+        fwrite(row.data(), 1, row.size(), f);
+    }
+    fclose(f);
+    return true;
+}
+
+static bool ReadPPM(const std::string& path, std::vector<uint32_t>& pixels)
+{
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f)
+        return false;
+    int w = 0, h = 0, max = 0;
+    const bool ok = fscanf(f, "P6 %d %d %d", &w, &h, &max) == 3 && fgetc(f) != EOF && w == WIDTH && h == HEIGHT && max == 255;
+    std::vector<unsigned char> rgb(WIDTH * HEIGHT * 3);
+    if (!ok || fread(rgb.data(), 1, rgb.size(), f) != rgb.size())
+    {
+        fclose(f);
+        return false;
+    }
+    fclose(f);
+    pixels.resize(WIDTH * HEIGHT);
+    for (int i = 0; i < WIDTH * HEIGHT; i++)
+        pixels[i] = (uint32_t)rgb[i * 3 + 0] << 16 | (uint32_t)rgb[i * 3 + 1] << 8 | rgb[i * 3 + 2];
+    return true;
+}
+
+// Returns the number of pixels with a channel differing by more than 'tolerance'
+static int ComparePixels(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b, int tolerance, int* out_max_diff)
+{
+    int bad = 0, max_diff = 0;
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        int diff = 0;
+        for (int shift = 0; shift < 24; shift += 8)
+            diff = std::max(diff, abs((int)((a[i] >> shift) & 0xff) - (int)((b[i] >> shift) & 0xff)));
+        max_diff = std::max(max_diff, diff);
+        if (diff > tolerance)
+            bad++;
+    }
+    *out_max_diff = max_diff;
+    return bad;
+}
+
+//-----------------------------------------------------------------------------
+// Main
+//-----------------------------------------------------------------------------
+
+struct Options
+{
+    bool        Update = false;
+    std::string Ref = IMGUI_NULL_RASTER_REFERENCE;
+    int         Threads = 0;
+    int         Frames = 60;
+    int         Tolerance = 2;
+    double      MaxBad = 0.001;
+    bool        Occlusion = false;
+    bool        Layers = false;
+    bool        Stats = false;
+    bool        Linear = false;
+    int         Polyline = 0;
+    std::string Record;
+    std::string Shm;
+    std::vector<std::string> Scenes;
+};
+
+// Renders the scene into 'result' (the first timed frame) and prints the timings unless 'quiet'
+// 'opaque' makes the window backgrounds opaque, which gives ImGuiImplRasterFlags_OcclusionCulling something to cull
+static void RenderScene(const Scene& scene, const Options& opt, bool opaque, bool quiet, std::vector<uint32_t>& result)
+{
+    std::vector<uint32_t> pixels(WIDTH * HEIGHT);
+
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.IniFilename = NULL;
+    io.DisplaySize = ImVec2((float)WIDTH, (float)HEIGHT);
+    io.DeltaTime = 1.0f / 60.0f;
+    ImGui::StyleColorsDark();
+
+    ImGuiImplRasterinfo info = {};
+    info.pixels = pixels.data();
+    info.width = WIDTH;
+    info.height = HEIGHT;
+    info.pitch = WIDTH;
+    info.threads = (uint32_t)opt.Threads;
+    info.format = ImGuiImplRasterFormat_BGRA32;
+    info.flags = opt.Occlusion ? ImGuiImplRasterFlags_OcclusionCulling : ImGuiImplRasterFlags_None;
+    if (opt.Layers)
+        info.flags |= ImGuiImplRasterFlags_LayerCache;
+    if (opt.Stats)
+        info.flags |= ImGuiImplRasterFlags_Stats;
+    if (opt.Linear)
+        info.flags |= ImGuiImplRasterFlags_LinearBlending;
+    if (!opt.Shm.empty())
+    {
+        info.flags |= ImGuiImplRasterFlags_DirtyRects;
+        info.clear = 0x203040;
+    }
+    ImGui_ImplRaster_Init(&info);
+    const ImGuiImplRasterSharedHeader* shared = NULL;
+    if (!opt.Shm.empty() && (shared = ImGui_ImplRaster_CreateSharedTarget(opt.Shm.c_str())) == NULL)
+        fprintf(stderr, "Cannot create the shared memory target %s\n", opt.Shm.c_str());
+    if (opaque)
+        ImGui::GetStyle().Colors[ImGuiCol_WindowBg].w = 1.0f;
+    FILE* record = NULL;
+    if (!opt.Record.empty())
+    {
+        const std::string path = opt.Record + "/" + scene.Name + ".y4m";
+        record = fopen(path.c_str(), "wb");
+        if (!record || !ImGui_ImplRaster_BeginStream(fileno(record), ImGuiImplRasterStreamFormat_Y4M))
+            fprintf(stderr, "Cannot record to %s\n", path.c_str());
+    }
+
+    // Only the renderer is timed, the ImGui frame and the clear are not
+    double seconds = 0.0;
+    long long triangles = 0;
+    ImGuiImplRasterStats stats = {};
+    for (int frame = 0; frame < WARMUP_FRAMES + opt.Frames; frame++)
+    {
+        ImGui_ImplRaster_NewFrame();
+        ImGui::NewFrame();
+        scene.Draw(frame);
+        ImGui::Render();
+
+        for (size_t i = 0; i < pixels.size(); i++)
+            pixels[i] = 0x203040;
+        ImDrawData* draw_data = ImGui::GetDrawData();
+        const auto t0 = std::chrono::high_resolution_clock::now();
+        ImGui_ImplRaster_RenderDrawData(draw_data);
+        const auto t1 = std::chrono::high_resolution_clock::now();
+        // The first timed frame is compared, so the references do not depend on --frames
+        if (frame == WARMUP_FRAMES && shared)
+        {
+            const uint8_t* buffer = (const uint8_t*)shared + shared->buffer_offset + (shared->latest % shared->buffer_count) * shared->buffer_stride;
+            result.assign((const uint32_t*)buffer, (const uint32_t*)buffer + WIDTH * HEIGHT);
+        }
+        else if (frame == WARMUP_FRAMES)
+            result = pixels;
+        if (frame == WARMUP_FRAMES && opt.Stats)
+            stats = *ImGui_ImplRaster_GetStats();
+        if (frame >= WARMUP_FRAMES)
+        {
+            seconds += std::chrono::duration<double>(t1 - t0).count();
+            triangles += draw_data->TotalIdxCount / 3;
+        }
+    }
+
+    if (record)
+    {
+        const int dropped = ImGui_ImplRaster_EndStream();
+        if (dropped > 0)
+            fprintf(stderr, "%s: %d frames dropped from the recording\n", scene.Name, dropped);
+        fclose(record);
+    }
+    ImGui_ImplRaster_Shutdown();
+    ImGui::DestroyContext();
+
+    if (quiet)
+        return;
+    if (opt.Stats)
+        printf("%-8s %u triangles, %u culled, %u rasterized, %llu pixels written, overdraw %.2f\n", scene.Name, stats.triangles_submitted,
+            stats.triangles_culled, stats.triangles_rasterized, (unsigned long long)stats.pixels_written, (double)stats.pixels_written / (WIDTH * HEIGHT));
+    printf("%-8s %8.3f ms/frame %9.1f Mpixels/s %8.2f Mtriangles/s  ", scene.Name,
+        seconds * 1000.0 / opt.Frames, (double)WIDTH * HEIGHT * opt.Frames / seconds * 1e-6, triangles / seconds * 1e-6);
+}
+
+// Culling must never change a pixel: the culled frames, serial and threaded, must match the unculled one exactly.
+// The opaque backgrounds change the scene, so the stored references are not used.
+static bool CheckOcclusion(const Scene& scene, const Options& opt, const std::vector<uint32_t>& result)
+{
+    Options unculled = opt;
+    unculled.Occlusion = false;
+    unculled.Threads = 0;
+    unculled.Stats = false;
+    unculled.Record.clear();
+    unculled.Shm.clear();
+    std::vector<uint32_t> reference, other;
+    RenderScene(scene, unculled, true, true, reference);
+
+    Options culled = unculled;
+    culled.Occlusion = true;
+    culled.Threads = opt.Threads ? 0 : 4;
+    RenderScene(scene, culled, true, true, other);
+
+    int max_diff = 0;
+    const int bad = ComparePixels(result, reference, 0, &max_diff);
+    const int bad_other = ComparePixels(other, reference, 0, &max_diff);
+    const bool ok = bad == 0 && bad_other == 0;
+    printf("%s (culled, %d and %d threads, against unculled: %d and %d pixels differ)\n", ok ? "ok" : "FAILED",
+        opt.Threads, culled.Threads, bad, bad_other);
+    if (!ok)
+        WritePPM(opt.Ref + "/" + scene.Name + ".out.ppm", bad ? result : other);
+    return ok;
+}
+
+// Returns false if the scene does not match its reference
+static bool RunScene(const Scene& scene, const Options& opt)
+{
+    std::vector<uint32_t> result;
+    RenderScene(scene, opt, opt.Occlusion, false, result);
+    if (opt.Occlusion)
+        return CheckOcclusion(scene, opt, result);
+
+    const std::string path = opt.Ref + "/" + scene.Name + ".ppm";
+    if (opt.Update)
+    {
+        const bool ok = WritePPM(path, result);
+        printf("%s %s\n", ok ? "wrote" : "FAILED to write", path.c_str());
+        return ok;
+    }
+    std::vector<uint32_t> reference;
+    if (!ReadPPM(path, reference))
+    {
+        printf("FAILED: cannot read %s (run with --update to re-baseline)\n", path.c_str());
+        return false;
+    }
+    int max_diff = 0;
+    const int bad = ComparePixels(result, reference, opt.Tolerance, &max_diff);
+    const bool ok = bad <= opt.MaxBad * WIDTH * HEIGHT;
+    printf("%s (%d pixels over tolerance, max difference %d)\n", ok ? "ok" : "FAILED", bad, max_diff);
+    if (!ok)
+        WritePPM(opt.Ref + "/" + scene.Name + ".out.ppm", result);
+    return ok;
+}
+
+// Tessellation only: the lines are built into a draw list and never rendered
+static void BenchPolyline(const Options& opt)
+{
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.IniFilename = NULL;
+    io.DisplaySize = ImVec2((float)WIDTH, (float)HEIGHT);
+    io.DeltaTime = 1.0f / 60.0f;
+    unsigned char* tex_pixels;
+    int tex_w, tex_h;
+    io.Fonts->GetTexDataAsAlpha8(&tex_pixels, &tex_w, &tex_h);
+
+    std::vector<ImVec2> points(opt.Polyline);
+    for (int i = 0; i < opt.Polyline; i++)
+        points[i] = ImVec2(i * (float)WIDTH / opt.Polyline, HEIGHT * 0.5f + sinf(i * 0.05f) * HEIGHT * 0.4f);
+    const float thicknesses[] = { 1.0f, 3.0f };
+    for (int decimate = 0; decimate < 2; decimate++)
+        for (float thickness : thicknesses)
+            for (int closed = 0; closed < 2; closed++)
+            {
+                double seconds = 0.0;
+                int vtx_count = 0;
+                for (int frame = 0; frame < WARMUP_FRAMES + opt.Frames; frame++)
+                {
+                    ImGui::NewFrame();
+                    ImDrawList* draw_list = ImGui::GetBackgroundDrawList();
+                    draw_list->Flags |= ImDrawListFlags_AntiAliasedLines | (decimate ? ImDrawListFlags_DecimateLines : 0);
+                    const auto t0 = std::chrono::high_resolution_clock::now();
+                    draw_list->AddPolyline(points.data(), opt.Polyline, IM_COL32(255, 200, 64, 255), closed != 0, thickness);
+                    const auto t1 = std::chrono::high_resolution_clock::now();
+                    if (frame >= WARMUP_FRAMES)
+                        seconds += std::chrono::duration<double>(t1 - t0).count();
+                    vtx_count = draw_list->VtxBuffer.Size;
+                    ImGui::EndFrame();
+                }
+                printf("polyline %d points, thickness %.0f, %-6s %-9s %8.3f ms %8.1f Mpoints/s %9d vertices\n", opt.Polyline, thickness, closed ? "closed" : "open",
+                    decimate ? "decimated" : "", seconds * 1000.0 / opt.Frames, (double)opt.Polyline * opt.Frames / seconds * 1e-6, vtx_count);
+            }
+    ImGui::DestroyContext();
+}
+
+int main(int argc, char** argv)
+{
+    IMGUI_CHECKVERSION();
+
+    Options opt;
+    for (int i = 1; i < argc; i++)
+    {
+        const bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--update") == 0)
+            opt.Update = true;
+        else if (strcmp(argv[i], "--ref") == 0 && has_value)
+            opt.Ref = argv[++i];
+        else if (strcmp(argv[i], "--threads") == 0 && has_value)
+            opt.Threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--frames") == 0 && has_value)
+            opt.Frames = std::max(atoi(argv[++i]), 1);
+        else if (strcmp(argv[i], "--tolerance") == 0 && has_value)
+            opt.Tolerance = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--max-bad") == 0 && has_value)
+            opt.MaxBad = atof(argv[++i]);
+        else if (strcmp(argv[i], "--occlusion") == 0)
+            opt.Occlusion = true;
+        else if (strcmp(argv[i], "--layers") == 0)
+            opt.Layers = true;
+        else if (strcmp(argv[i], "--stats") == 0)
+            opt.Stats = true;
+        else if (strcmp(argv[i], "--linear") == 0)
+            opt.Linear = true;
+        else if (strcmp(argv[i], "--record") == 0 && has_value)
+            opt.Record = argv[++i];
+        else if (strcmp(argv[i], "--shm") == 0 && has_value)
+            opt.Shm = argv[++i];
+        else if (strcmp(argv[i], "--polyline") == 0 && has_value)
+            opt.Polyline = std::max(atoi(argv[++i]), 2);
+        else if (argv[i][0] == '-')
+        {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 2;
+        }
+        else
+            opt.Scenes.push_back(argv[i]);
+    }
+
+    if (opt.Update && opt.Occlusion)
+    {
+        fprintf(stderr, "--occlusion compares against the unculled frame and has no references to update\n");
+        return 2;
+    }
+    if (opt.Polyline)
+    {
+        BenchPolyline(opt);
+        return 0;
+    }
+
+    int failed = 0, run = 0;
+    for (const Scene& scene : g_Scenes)
+    {
+        bool selected = opt.Scenes.empty();
+        for (const std::string& name : opt.Scenes)
+            selected |= name == scene.Name;
+        if (!selected)
+            continue;
+        run++;
+        if (!RunScene(scene, opt))
+            failed++;
+    }
+    if (run == 0)
+    {
+        fprintf(stderr, "No such scene\n");
+        return 2;
+    }
+    return failed ? 1 : 0;
+}
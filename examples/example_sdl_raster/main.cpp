@@ -34,10 +34,14 @@ int main(int, char**)
     // Setup Platform/Renderer bindings
     ImGui_ImplSDL2_InitForRaster(window);
     ImGuiImplRasterinfo info = {
-      (uint32_t*)(surface->pixels),
+      surface->pixels,
       uint32_t(surface->w),
       uint32_t(surface->h),
-      uint32_t(surface->pitch / 4)
+      uint32_t(surface->pitch / surface->format->BytesPerPixel),
+      0,                                // threads
+      ImGuiImplRasterFlags_DirtyRects,  // only redraw what changed, the back-end clears the surface
+      0x203040,                         // clear colour
+      surface->format->format == SDL_PIXELFORMAT_RGB565 ? ImGuiImplRasterFormat_RGB565 : ImGuiImplRasterFormat_BGRA32
     };
     ImGui_ImplRaster_Init(&info);
 
@@ -60,6 +64,7 @@ int main(int, char**)
     // Our state
     bool show_demo_window = true;
     bool show_another_window = false;
+    bool show_metrics_window = false;
     ImVec4 clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
 
     // Main loop
@@ -98,6 +103,7 @@ int main(int, char**)
             ImGui::Text("This is some useful text.");               // Display some text (you can use a format strings too)
             ImGui::Checkbox("Demo Window", &show_demo_window);      // Edit bools storing our window open/close state
             ImGui::Checkbox("Another Window", &show_another_window);
+            ImGui::Checkbox("Metrics Window", &show_metrics_window);
 
             ImGui::SliderFloat("float", &f, 0.0f, 1.0f);            // Edit 1 float using a slider from 0.0f to 1.0f
             ImGui::ColorEdit3("clear color", (float*)&clear_color); // Edit 3 floats representing a color
@@ -121,14 +127,19 @@ int main(int, char**)
             ImGui::End();
         }
 
+        // 4. Show the metrics window, with a section about the software renderer
+        if (show_metrics_window)
+            ImGui_ImplRaster_ShowMetricsWindow(&show_metrics_window);
+
         // Rendering
         ImGui::Render();
         SDL_Delay(10);
 
-        //glUseProgram(0); // You may want this if using this code in an OpenGL 3+ context where shaders may be bound
-        SDL_FillRect(surface, nullptr, 0x203040);
         ImGui_ImplRaster_RenderDrawData(ImGui::GetDrawData());
-        SDL_UpdateWindowSurface(window);
+        const ImGuiImplRasterRect* rects;
+        int rects_count = ImGui_ImplRaster_GetDirtyRects(&rects);
+        if (rects_count > 0)
+            SDL_UpdateWindowSurfaceRects(window, (const SDL_Rect*)rects, rects_count); // ImGuiImplRasterRect has the same layout as SDL_Rect
     }
 
     // Cleanup
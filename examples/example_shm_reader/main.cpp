@@ -0,0 +1,174 @@
+// dear imgui: reader of an imgui_impl_raster shared memory target
+// (another process renders with ImGui_ImplRaster_CreateSharedTarget(), this one follows the frames without locks)
+//
+// Usage: example_shm_reader [options] NAME
+//   --frames N      stop after N frames (default: run until the writer goes away)
+//   --ppm FILE      write the last frame read as a binary PPM
+// Prints the sequence number and dirty rectangles of every frame seen. Frames published faster than they are
+// polled are skipped, which the sequence numbers show. E.g. "example_null_raster --shm /imgui" in another shell.
+#include "imgui.h"
+#include "imgui_impl_raster.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const int POLL_MICROSECONDS = 1000;
+static const int IDLE_SECONDS = 5;          // give up once no frame was published for that long
+
+static uint64_t LoadAcquire(const uint64_t& v)
+{
+    return reinterpret_cast<const std::atomic<uint64_t>&>(v).load(std::memory_order_acquire);
+}
+
+// Copy the latest complete frame and its slot, returns its sequence number (0 if there is none yet)
+static uint64_t ReadLatest(const ImGuiImplRasterSharedHeader* header, std::vector<uint8_t>& out, ImGuiImplRasterSharedSlot& out_slot)
+{
+    const size_t size = (size_t)header->pitch * header->height;
+    out.resize(size);
+    for (;;)
+    {
+        const uint64_t sequence = LoadAcquire(header->latest);
+        if (sequence == 0)
+            return 0;
+        const uint32_t index = (uint32_t)(sequence % header->buffer_count);
+        memcpy(out.data(), (const uint8_t*)header + header->buffer_offset + index * header->buffer_stride, size);
+        memcpy(&out_slot, &header->slots[index], sizeof(out_slot));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        // Still the same frame: the copy is consistent. Otherwise the writer lapped us, take the newer one.
+        if (LoadAcquire(header->slots[index].sequence) == sequence)
+            return sequence;
+    }
+}
+
+// Converts any target format to RGB
+static bool WritePPM(const char* path, const ImGuiImplRasterSharedHeader* header, const std::vector<uint8_t>& pixels)
+{
+    FILE* f = fopen(path, "wb");
+    if (!f)
+        return false;
+    fprintf(f, "P6\n%u %u\n255\n", header->width, header->height);
+    std::vector<unsigned char> row(header->width * 3);
+    for (uint32_t y = 0; y < header->height; y++)
+    {
+        const uint8_t* src = pixels.data() + (size_t)y * header->pitch;
+        for (uint32_t x = 0; x < header->width; x++)
+        {
+            unsigned char* rgb = &row[x * 3];
+            switch (header->format)
+            {
+            case ImGuiImplRasterFormat_BGRA32: rgb[0] = src[x * 4 + 2]; rgb[1] = src[x * 4 + 1]; rgb[2] = src[x * 4 + 0]; break;
+            case ImGuiImplRasterFormat_RGBA32: rgb[0] = src[x * 4 + 0]; rgb[1] = src[x * 4 + 1]; rgb[2] = src[x * 4 + 2]; break;
+            case ImGuiImplRasterFormat_RGB565:
+            {
+                const unsigned c = src[x * 2] | src[x * 2 + 1] << 8;
+                const unsigned r = c >> 11, g = (c >> 5) & 63, b = c & 31;
+                rgb[0] = (unsigned char)(r << 3 | r >> 2); rgb[1] = (unsigned char)(g << 2 | g >> 4); rgb[2] = (unsigned char)(b << 3 | b >> 2);
+                break;
+            }
+            default: rgb[0] = rgb[1] = rgb[2] = src[x]; break;
+            }
+        }
+        fwrite(row.data(), 1, row.size(), f);
+    }
+    return fclose(f) == 0;
+}
+
+int main(int argc, char** argv)
+{
+    const char* name = NULL;
+    const char* ppm = NULL;
+    long long max_frames = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        const bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--frames") == 0 && has_value)
+            max_frames = atoll(argv[++i]);
+        else if (strcmp(argv[i], "--ppm") == 0 && has_value)
+            ppm = argv[++i];
+        else if (argv[i][0] != '-' && !name)
+            name = argv[i];
+        else
+        {
+            fprintf(stderr, "Usage: %s [--frames N] [--ppm FILE] NAME\n", argv[0]);
+            return 2;
+        }
+    }
+    if (!name)
+    {
+        fprintf(stderr, "Usage: %s [--frames N] [--ppm FILE] NAME\n", argv[0]);
+        return 2;
+    }
+
+    // Wait for the writer to create the object
+    const auto start = std::chrono::steady_clock::now();
+    int fd = -1;
+    struct stat st;
+    while ((fd = shm_open(name, O_RDONLY, 0)) < 0 || fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(ImGuiImplRasterSharedHeader))
+    {
+        if (fd >= 0)
+            close(fd);
+        if (std::chrono::steady_clock::now() - start > std::chrono::seconds(IDLE_SECONDS))
+        {
+            fprintf(stderr, "Cannot open %s\n", name);
+            return 1;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(POLL_MICROSECONDS));
+    }
+    void* mapping = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        fprintf(stderr, "Cannot map %s\n", name);
+        return 1;
+    }
+    const ImGuiImplRasterSharedHeader* header = (const ImGuiImplRasterSharedHeader*)mapping;
+    while (reinterpret_cast<const std::atomic<uint32_t>&>(header->magic).load(std::memory_order_acquire) != ImGuiImplRasterShared_Magic)
+        std::this_thread::sleep_for(std::chrono::microseconds(POLL_MICROSECONDS));
+    if (header->size != sizeof(ImGuiImplRasterSharedHeader))
+    {
+        fprintf(stderr, "%s: header of %u bytes, expected %u\n", name, header->size, (unsigned)sizeof(ImGuiImplRasterSharedHeader));
+        return 1;
+    }
+    printf("%s: %ux%u, format %d, pitch %u, %u buffers\n", name, header->width, header->height, header->format, header->pitch, header->buffer_count);
+
+    std::vector<uint8_t> pixels;
+    ImGuiImplRasterSharedSlot slot;
+    uint64_t last = 0;
+    long long frames = 0, skipped = 0;
+    auto last_seen = std::chrono::steady_clock::now();
+    while (max_frames == 0 || frames < max_frames)
+    {
+        const uint64_t sequence = ReadLatest(header, pixels, slot);
+        if (sequence == last)
+        {
+            if (std::chrono::steady_clock::now() - last_seen > std::chrono::seconds(IDLE_SECONDS))
+                break;
+            std::this_thread::sleep_for(std::chrono::microseconds(POLL_MICROSECONDS));
+            continue;
+        }
+        // The rectangles are only those of this frame, not of the ones skipped
+        printf("frame %llu:", (unsigned long long)sequence);
+        for (uint32_t i = 0; i < slot.rect_count && i < ImGuiImplRasterShared_MaxRects; i++)
+            printf(" [%d %d %d %d]", slot.rects[i].x, slot.rects[i].y, slot.rects[i].w, slot.rects[i].h);
+        printf("\n");
+        if (sequence > last)
+            skipped += (long long)(sequence - last - 1);
+        last = sequence;
+        frames++;
+        last_seen = std::chrono::steady_clock::now();
+    }
+    printf("%lld frames read, %lld skipped\n", frames, skipped);
+
+    if (ppm && last != 0 && !WritePPM(ppm, header, pixels))
+        fprintf(stderr, "Cannot write %s\n", ppm);
+    munmap(mapping, (size_t)st.st_size);
+    return 0;
+}
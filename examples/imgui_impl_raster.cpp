@@ -1,239 +1,3613 @@
-// dear imgui: Renderer for OpenGL2 (legacy OpenGL, fixed pipeline)
+// dear imgui: Renderer for Software Rasterization
 // This needs to be used along with a Platform Binding (e.g. GLFW, SDL, Win32, custom..)
 
+// Implemented features:
+//  [X] Renderer: Optional tile-binned rendering on a pool of worker threads (set ImGuiImplRasterinfo::threads).
+//  [X] Renderer: SSE2/AVX2 row kernels, selected at runtime from the CPU features.
+//  [X] Renderer: Source-over alpha blending of vertex colour times texture alpha.
+//  [X] Renderer: Axis aligned rectangles (PrimRect, PrimRectUV, glyphs) are filled/blitted as row spans, 1:1 glyphs are copied from the atlas rows.
+//  [X] Renderer: Optional incremental redraw of the regions that changed (ImGuiImplRasterFlags_DirtyRects).
+//  [X] Renderer: User textures (RGBA32/Alpha8 CPU images) with nearest/bilinear (or per primitive automatic) filtering and clamp/wrap addressing. See ImGui_ImplRaster_CreateTexture().
+//  [X] Renderer: Independent renderer contexts, usable concurrently from different threads. See ImGui_ImplRaster_CreateContext().
+//  [X] Renderer: Gouraud shaded (per vertex colour) triangles, e.g. AddRectFilledMultiColor() and the colour picker.
+//  [X] Renderer: BGRA32, RGBA32, RGB565 and A8 targets (see ImGuiImplRasterinfo::format), drawn natively without a conversion pass.
+//  [X] Renderer: Optional occlusion culling of geometry behind opaque rectangles (ImGuiImplRasterFlags_OcclusionCulling).
+//  [X] Renderer: Optional cache of the draw lists that stopped changing, composited as layers (ImGuiImplRasterFlags_LayerCache).
+//  [X] Renderer: Streaming of the rendered frames to a file descriptor (raw RGBA, Y4M, PPM). See ImGui_ImplRaster_BeginStream().
+//  [X] Renderer: Rendering into a POSIX shared memory ring of framebuffers read lock-free by another process. See ImGui_ImplRaster_CreateSharedTarget().
+//  [X] Renderer: Optional triangle/pixel counters and timings per draw list and overdraw heatmap (ImGuiImplRasterFlags_Stats, ImGuiImplRasterFlags_OverdrawHeatmap). See ImGui_ImplRaster_ShowMetricsWindow().
+//  [X] Renderer: Optional gamma-correct blending in linear light, through sRGB tables (ImGuiImplRasterFlags_LinearBlending).
+//  [X] Renderer: 28.4 fixed point edge functions with the top-left fill rule (float core with ImGuiImplRasterFlags_FloatRasterizer).
+
 // You can copy and use unmodified imgui_impl_* files in your project. See main.cpp for an example of using this.
 // If you are new to dear imgui, read examples/README.txt and read the documentation at the top of imgui.cpp.
 // https://github.com/ocornut/imgui
 
 // CHANGELOG
 // (minor and older changes stripped away, please see git history for details)
+//  2020-04-06: raster: Added support for large mesh (64K+ vertices), enable ImGuiBackendFlags_RendererHasVtxOffset flag. 32-bit ImDrawIdx builds work as well.
+//  2020-04-05: raster: Added ImGuiImplRasterFlags_LinearBlending, blending in linear light with sRGB <-> linear tables (AVX2 gathers them). Translucent fills look their result up in per colour tables.
+//  2020-04-04: raster: Added ImGuiImplRasterFlags_Stats, ImGui_ImplRaster_GetStats() and ImGuiImplRasterFlags_OverdrawHeatmap: per draw list triangle and pixel counters, phase timings and a heatmap of the writes per pixel. ImGui_ImplRaster_ShowMetricsWindow() adds them to the metrics window.
+//  2020-04-03: raster: Long thin triangles (covering under a quarter of their bounds) are walked row by row from the range their edges cover instead of scanning their bounds.
+//  2020-04-02: raster: Added ImGuiImplRasterTextureFlags_AutoFilter, picking nearest or bilinear filtering per primitive from its UV derivatives. The font atlas uses it, so scaled text is filtered. Bilinear filtering is done in 8.8 fixed point SSE2/AVX2 (AVX2 gathers RGBA32 taps).
+//  2020-04-01: raster: Added ImGui_ImplRaster_CreateSharedTarget() and ImGui_ImplRaster_DestroySharedTarget(), rendering into a ring of framebuffers in POSIX shared memory with a lock-free header of sequence numbers and dirty rectangles.
+//  2020-03-31: raster: Added ImGui_ImplRaster_BeginStream() and ImGui_ImplRaster_EndStream(), writing the rendered frames as raw RGBA, Y4M or PPM from a writer thread.
+//  2020-03-30: raster: Added ImGuiImplRasterFlags_LayerCache and ImGuiImplRasterinfo::layer_cache_size: unchanged draw lists are composited from a cached layer.
+//  2020-03-29: raster: Added ImGuiImplRasterFlags_OcclusionCulling, skipping geometry hidden per tile behind later opaque rectangles.
+//  2020-03-28: raster: Glyph quads mapping one atlas texel to one pixel blend the atlas rows directly instead of sampling each pixel.
+//  2020-03-27: raster: Added ImGuiImplRasterinfo::format with RGBA32, RGB565 (dithered) and A8 targets besides BGRA32. ImGuiImplRasterinfo::pixels and ImGui_ImplRaster_SetTarget() take a void pointer.
+//  2020-03-26: raster: Interpolate the vertex colours of untextured triangles instead of using the first vertex colour.
+//  2020-03-25: raster: Moved all state into ImGuiImplRasterContext. Added ImGui_ImplRaster_CreateContext(), ImGui_ImplRaster_DestroyContext(), ImGui_ImplRaster_Get/SetCurrentContext() and ImGui_ImplRaster_SetTarget().
+//  2020-03-24: raster: Added ImGui_ImplRaster_CreateTexture(), ImGui_ImplRaster_UpdateTexture() and ImGui_ImplRaster_DestroyTexture(). ImDrawCmd::TextureId is honoured, the font atlas is registered like any other texture.
+//  2020-03-23: raster: Triangles are rasterized with 28.4 fixed point edge functions and the top-left fill rule by default, so shared edges are drawn exactly once. Added ImGuiImplRasterFlags_FloatRasterizer for the previous float core.
+//  2020-03-22: raster: Added ImGuiImplRasterFlags_DirtyRects, ImGui_ImplRaster_GetDirtyRects() and ImGui_ImplRaster_InvalidateFrame().
+//  2020-03-21: raster: Blend vertex colour modulated by the atlas alpha over the target instead of writing opaque pixels.
+//  2020-03-20: raster: Added a fast path filling/blitting axis aligned quads as row spans instead of two triangles.
+//  2020-03-19: raster: Added SSE2/AVX2 row kernels with runtime selection, the scalar kernels remain as the portable fallback.
+//  2020-03-18: raster: Added tile-binned multithreaded rendering. Edge functions are evaluated per pixel centre so the output does not depend on the tiling.
 //  2020-03-11: raster: Created
 
-#include "imgui.h"
-#include "imgui_impl_raster.h"
+#include "imgui.h"
+#include "imgui_impl_raster.h"
+
+#if defined(_MSC_VER) && _MSC_VER <= 1500 // MSVC 2008 or earlier
+#include <stddef.h>     // intptr_t
+#else
+#include <stdint.h>     // intptr_t
+#endif
+#include <errno.h>
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(_WIN32)
+#include <io.h>         // _write
+#else
+#include <unistd.h>     // write
+#endif
+// POSIX shared memory, see ImGui_ImplRaster_CreateSharedTarget()
+#if defined(__unix__) || defined(__APPLE__)
+#define IMGUI_IMPL_RASTER_SHARED
+#include <fcntl.h>      // O_CREAT
+#include <sys/mman.h>   // shm_open, mmap
+#endif
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// SIMD kernels are used when the compiler targets SSE2 (always the case on x64), AVX2 ones are
+// compiled in as well and picked at runtime if the CPU supports them.
+// #define IMGUI_IMPL_RASTER_DISABLE_SIMD to only use the portable scalar kernels.
+#if !defined(IMGUI_IMPL_RASTER_DISABLE_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define IMGUI_IMPL_RASTER_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define IMGUI_IMPL_RASTER_AVX2
+#define RASTER_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && _MSC_VER >= 1700
+#define IMGUI_IMPL_RASTER_AVX2
+#define RASTER_TARGET_AVX2
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+#endif
+
+struct rect_t {
+  int32_t x0, y0, x1, y1;
+
+  bool empty() const {
+    return x0 >= x1 || y0 >= y1;
+  }
+};
+
+static inline rect_t intersect(const rect_t &a, const rect_t &b) {
+  return rect_t{std::max(a.x0, b.x0), std::max(a.y0, b.y0),
+                std::min(a.x1, b.x1), std::min(a.y1, b.y1)};
+}
+
+static inline rect_t project_rect(const ImVec4 &r, const ImVec2 &clip_off, const ImVec2 &clip_scale) {
+  return rect_t{
+      int32_t((r.x - clip_off.x) * clip_scale.x), int32_t((r.y - clip_off.y) * clip_scale.y),
+      int32_t((r.z - clip_off.x) * clip_scale.x), int32_t((r.w - clip_off.y) * clip_scale.y) };
+}
+
+static inline rect_t bounding(const rect_t &a, const rect_t &b) {
+  if (a.empty()) return b;
+  if (b.empty()) return a;
+  return rect_t{std::min(a.x0, b.x0), std::min(a.y0, b.y0),
+                std::max(a.x1, b.x1), std::max(a.y1, b.y1)};
+}
+
+struct vec2f_t {
+
+  void operator += (const vec2f_t &p) {
+    x += p.x; y += p.y;
+  }
+
+  float x, y;
+};
+
+bool operator == (const ImVec2 &a, const ImVec2 &b) {
+  return a.x == b.x && a.y == b.y;
+}
+
+// An affine function of the pixel centre, v(x, y) = a * x + b * y + c, with x and y relative
+// to the triangle origin. It is always evaluated directly as row(y) + a * x, never by stepping,
+// so the value at a pixel does not depend on where a span or a tile starts.
+struct plane_t {
+
+  float row(float y) const {
+    return b * y + c;
+  }
+
+  float a, b, c;
+};
+
+// A texture registered with ImGui_ImplRaster_CreateTexture(), slot 0 is the font atlas
+struct texture_t {
+  uint32_t w, h;
+  const uint8_t *tex;   // first texel, NULL for a free slot
+  int32_t pitch;        // bytes from one row to the next
+  uint32_t sampler;     // texture_sampler(), picks the textured kernel specialisation
+  bool auto_filter;     // ImGuiImplRasterTextureFlags_AutoFilter, see filter_texture()
+  uint32_t version;     // changes whenever the contents may have changed
+};
+
+// Fixed point edge function, E(x, y) = a * x + b * y + c in 28.4 units at the centre of
+// pixel (x, y) relative to the triangle origin. The fill rule bias is folded into c, so a
+// pixel is covered when E >= 0 for all three edges.
+struct fixed_edge_t {
+  int64_t a, b, c;
+};
+
+// Triangle set up for rasterization: clipped pixel bounds and the three edge functions
+struct triangle_t {
+  rect_t bounds;
+  int32_t ox, oy;
+  plane_t e0, e1, e2;       // float edge functions, also used to interpolate attributes
+  fixed_edge_t f0, f1, f2;  // fixed point edge functions
+  float area;
+  bool swapped;   // v1 and v2 were exchanged to fix the winding
+  bool fixed;     // coverage uses the fixed point edges
+  bool wide;      // fixed point edge values may not fit in 32 bits within the bounds
+  bool walk;      // rows start and end on the triangle edges instead of its bounds, see solve_row()
+};
+
+// Work done drawing a draw list, see ImGuiImplRasterFlags_Stats
+struct raster_count_t {
+  uint64_t rasterized;      // triangles set up, rectangles count as 2. Counted once per primitive by the
+                            // caller of draw_prim(), or when binning in tiled mode, never per tile.
+  uint64_t tested;          // pixels handed to the kernels
+  uint64_t written;         // pixels covered
+};
+
+struct raster_kernels_t;
+
+// What the primitive rasterizers need to know about the target of a context
+struct raster_target_t {
+  uint8_t *pixels;
+  int32_t x0, y0;           // coordinates of the first pixel, non zero when drawing into a layer
+  uint32_t pitch;           // bytes from one row to the next
+  uint32_t bpp;             // bytes per pixel
+  // conversion of rows from/to the staging format, NULL for BGRA32 targets drawn in place
+  void (*load)(const uint8_t *src, int32_t count, uint32_t *out);
+  void (*store)(uint8_t *dst, int32_t x, int32_t y, int32_t count, const uint32_t *in);
+  uint32_t white;           // or'ed into the vertex colours, A8 targets only keep the alpha
+  const raster_kernels_t *kernels;  // g_kernels, or g_kernels_linear with ImGuiImplRasterFlags_LinearBlending
+  bool fixed;               // 28.4 fixed point core, see setup_triangle()
+  const texture_t *font;    // untextured geometry uses the font atlas white pixel
+  raster_count_t *counts;   // per draw list counters of the drawing thread, NULL unless ImGuiImplRasterFlags_Stats
+  int32_t list;             // draw list being drawn, index into 'counts'
+};
+
+// ImDrawVert::col (0xAABBGGRR) to 0xAARRGGBB
+static inline uint32_t swizzle(uint32_t x) {
+  return ((x >> 16) & 0xff) | ((x << 16) & 0xff0000) | (x & 0xff00ff00);
+}
+
+// Conservative pixel bounds of a triangle, also used by the tile binner
+static inline rect_t triangle_bounds(
+    const vec2f_t& v0,
+    const vec2f_t& v1,
+    const vec2f_t& v2)
+{
+    return rect_t{
+        int32_t(floorf(std::min({v0.x, v1.x, v2.x}))),
+        int32_t(floorf(std::min({v0.y, v1.y, v2.y}))),
+        int32_t(ceilf (std::max({v0.x, v1.x, v2.x}))),
+        int32_t(ceilf (std::max({v0.y, v1.y, v2.y}))) };
+}
+
+// Edge function v0 -> v1, positive on the inside of a clockwise (on screen) triangle
+static inline plane_t edge_plane(const vec2f_t& v0, const vec2f_t& v1)
+{
+    return plane_t{
+        (v0.y - v1.y),
+        (v1.x - v0.x),
+        (v0.x * v1.y) - (v0.y * v1.x) + (v0.y - v1.y) * .5f + (v1.x - v0.x) * .5f };
+}
+
+// 28.4 sub pixel precision of the fixed point core
+static const int32_t SUBPIXEL_BITS = 4;
+static const int32_t SUBPIXEL = 1 << SUBPIXEL_BITS;
+
+static inline vec2f_t snap(const vec2f_t &v) {
+  return vec2f_t{ float(lrintf(v.x * SUBPIXEL)) / SUBPIXEL, float(lrintf(v.y * SUBPIXEL)) / SUBPIXEL };
+}
+
+// Same edge as edge_plane() on the 28.4 grid, with the top-left rule: pixel centres
+// exactly on an edge belong to the triangle only for top edges (horizontal, interior
+// below) and left edges (interior on the right), so shared edges are drawn once.
+static inline fixed_edge_t edge_fixed(int64_t x0, int64_t y0, int64_t x1, int64_t y1)
+{
+    const int64_t a = y0 - y1, b = x1 - x0;
+    const bool top_left = a > 0 || (a == 0 && b > 0);
+    return fixed_edge_t{
+        a * SUBPIXEL,
+        b * SUBPIXEL,
+        a * (SUBPIXEL / 2 - x0) + b * (SUBPIXEL / 2 - y0) - (top_left ? 0 : 1) };
+}
+
+// Largest |E| of an edge over a pixel rectangle (relative to the origin, inclusive)
+static inline int64_t edge_extent(const fixed_edge_t &e, int64_t x0, int64_t y0, int64_t x1, int64_t y1)
+{
+    const int64_t ex = std::max(std::llabs(e.a * x0), std::llabs(e.a * x1));
+    const int64_t ey = std::max(std::llabs(e.b * y0), std::llabs(e.b * y1));
+    return ex + ey + std::llabs(e.c);
+}
+
+// Long thin triangles (lines, polyline joins) cover a small part of their bounds, scanning
+// the rows of the bounds would mostly test pixels outside of them. Their rows are solved for
+// the covered range instead when the bounds are at least WALK_MIN_RATIO times the area.
+static const int32_t WALK_MIN_WIDTH = 16;
+static const float WALK_MIN_RATIO = 4.f;
+
+// Returns false if the triangle is degenerate or entirely clipped. The winding is normalised
+// so both clockwise and counter clockwise triangles are drawn (ImGui does not guarantee one).
+// The fixed point core (default) snaps the vertices to 1/16th of a pixel first, in absolute
+// coordinates, so a vertex shared by two triangles always lands on the same spot.
+static bool setup_triangle(
+    triangle_t &t,
+    bool fixed,
+    vec2f_t v0,
+    vec2f_t v1,
+    vec2f_t v2,
+    const rect_t &clip)
+{
+    t.fixed = fixed;
+    if (t.fixed) {
+        v0 = snap(v0);
+        v1 = snap(v1);
+        v2 = snap(v2);
+    }
+    const rect_t bb = triangle_bounds(v0, v1, v2);
+    t.bounds = intersect(bb, clip);
+    if (t.bounds.empty())
+        return false;
+    // work relative to the (unclipped) bounds so values stay small and tile independent
+    t.ox = bb.x0;
+    t.oy = bb.y0;
+    v0.x -= t.ox; v0.y -= t.oy;
+    v1.x -= t.ox; v1.y -= t.oy;
+    v2.x -= t.ox; v2.y -= t.oy;
+    if (t.fixed) {
+        // snapped relative coordinates are exact multiples of 1/16
+        int64_t x[3] = { int64_t(v0.x * SUBPIXEL), int64_t(v1.x * SUBPIXEL), int64_t(v2.x * SUBPIXEL) };
+        int64_t y[3] = { int64_t(v0.y * SUBPIXEL), int64_t(v1.y * SUBPIXEL), int64_t(v2.y * SUBPIXEL) };
+        const int64_t area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+        if (area == 0)
+            return false;
+        t.swapped = area < 0;
+        if (t.swapped) {
+            std::swap(x[1], x[2]);
+            std::swap(y[1], y[2]);
+        }
+        t.area = float(std::llabs(area)) / (SUBPIXEL * SUBPIXEL);
+        t.f0 = edge_fixed(x[1], y[1], x[2], y[2]);
+        t.f1 = edge_fixed(x[2], y[2], x[0], y[0]);
+        t.f2 = edge_fixed(x[0], y[0], x[1], y[1]);
+        // leave room for the SIMD kernels evaluating up to 8 pixels past the end of a row
+        const int64_t rx0 = t.bounds.x0 - t.ox, rx1 = t.bounds.x1 - t.ox + 8;
+        const int64_t ry0 = t.bounds.y0 - t.oy, ry1 = t.bounds.y1 - t.oy;
+        const int64_t extent = std::max({
+            edge_extent(t.f0, rx0, ry0, rx1, ry1),
+            edge_extent(t.f1, rx0, ry0, rx1, ry1),
+            edge_extent(t.f2, rx0, ry0, rx1, ry1) });
+        t.wide = extent >= (int64_t(1) << 31);
+    } else {
+        t.wide = false;
+        t.area = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+        if (t.area == 0.f)
+            return false;
+        t.swapped = t.area < 0.f;
+        if (t.swapped)
+            t.area = -t.area;
+    }
+    if (t.swapped)
+        std::swap(v1, v2);
+    t.e0 = edge_plane(v1, v2); // weight of v0
+    t.e1 = edge_plane(v2, v0); // weight of v1
+    t.e2 = edge_plane(v0, v1); // weight of v2
+    const int32_t w = t.bounds.x1 - t.bounds.x0, h = t.bounds.y1 - t.bounds.y0;
+    t.walk = t.wide || (w >= WALK_MIN_WIDTH && t.area * WALK_MIN_RATIO < float(w) * float(h));
+    return true;
+}
+
+// Range [x0, x1) of the pixels of row 'y' the triangle covers (walked triangles). It is
+// exact with the fixed point core, so the kernels skip the coverage tests. The float edges
+// give a range one pixel wider on each side, within which the coverage is still tested.
+static void solve_row(const triangle_t &t, int32_t y, int32_t &x0, int32_t &x1)
+{
+    if (!t.fixed) {
+        const plane_t *planes[3] = { &t.e0, &t.e1, &t.e2 };
+        float lo = float(t.bounds.x0 - t.ox), hi = float(t.bounds.x1 - t.ox);
+        for (const plane_t *e : planes) {
+            // covered where e->a * x + w >= 0
+            const float w = e->row(float(y - t.oy));
+            if (e->a > 0.f)
+                lo = std::max(lo, floorf(-w / e->a) - 1.f);
+            else if (e->a < 0.f)
+                hi = std::min(hi, floorf(w / -e->a) + 2.f);
+            else if (w < 0.f)
+                hi = lo;
+        }
+        if (!(lo < hi))
+            lo = hi = float(t.bounds.x0 - t.ox);
+        x0 = int32_t(lo) + t.ox;
+        x1 = int32_t(hi) + t.ox;
+        return;
+    }
+    const fixed_edge_t *edges[3] = { &t.f0, &t.f1, &t.f2 };
+    int64_t lo = t.bounds.x0 - t.ox, hi = t.bounds.x1 - t.ox;
+    for (const fixed_edge_t *e : edges) {
+        // covered where e->a * x + c >= 0
+        const int64_t c = e->b * (y - t.oy) + e->c;
+        if (e->a > 0)
+            lo = std::max(lo, c >= 0 ? -(c / e->a) : (-c + e->a - 1) / e->a);
+        else if (e->a < 0)
+            hi = std::min(hi, c >= 0 ? c / -e->a + 1 : -((-c + -e->a - 1) / -e->a) + 1);
+        else if (c < 0)
+            hi = lo;
+    }
+    x0 = int32_t(lo + t.ox);
+    x1 = int32_t(std::max(lo, hi) + t.ox);
+}
+
+// Plane interpolating a per vertex attribute across a triangle
+static inline plane_t attribute_plane(const triangle_t &t, float a0, float a1, float a2)
+{
+    if (t.swapped)
+        std::swap(a1, a2);
+    const float inv = 1.f / t.area;
+    return plane_t{
+        (t.e0.a * a0 + t.e1.a * a1 + t.e2.a * a2) * inv,
+        (t.e0.b * a0 + t.e1.b * a1 + t.e2.b * a2) * inv,
+        (t.e0.c * a0 + t.e1.c * a1 + t.e2.c * a2) * inv };
+}
+
+//-----------------------------------------------------------------------------
+// Row kernels
+//-----------------------------------------------------------------------------
+// The triangle loops hand one row at a time to a kernel, which tests coverage and
+// writes the covered pixels. The scalar kernels are the portable reference; the
+// SSE2/AVX2 kernels evaluate 4/8 pixels per step and must produce exactly the same
+// output. The best kernel set for the CPU is picked at runtime in Init.
+//
+// Colours are 0xAARRGGBB, i.e. swizzled ImDrawVert::col with the alpha kept. The
+// source is blended over the destination as dst = (src * a + dst * (255 - a)) / 255,
+// rounded, per channel. The scalar code does it two channels at a time in 16 bit
+// lanes of a 32 bit word, the SIMD code in 16 bit vector lanes, giving the same bits.
+// Alpha 255 reduces to a plain store and alpha 0 leaves the pixel untouched.
+//
+// With ImGuiImplRasterFlags_LinearBlending the kernels are instantiated with 'Linear':
+// the source and destination go through the sRGB tables and are blended in linear light
+// (see blend_linear()). Only the blend changes, vertex colours, texels and their product
+// are used as they are. The linear tables are picked per target (raster_target_t::kernels).
+//
+// Coverage comes either from the float edge planes or from the 28.4 fixed point edges.
+// The kernels are templates over that choice ('Fixed') and the table holds both.
+// Fixed point edge values are stepped incrementally with wrapping 32 bit adds, the
+// triangle setup guarantees the values actually tested fit in 32 bits.
+
+// One row of a triangle as seen by the kernels. Plane values are given at x = 0.
+struct span_t {
+  uint32_t *dst;      // first pixel of the row (x0)
+  int32_t count;      // number of pixels to test
+  int32_t px, py;     // target position of the first pixel
+  float x;            // triangle relative x of the first pixel
+  float w[3], dw[3];  // edge values and their x steps
+  int32_t e[3], de[3];// fixed point edge values at the first pixel and their x steps
+  float u, v, du, dv; // texture coordinates and their x steps
+  int32_t col[4], dcol[4]; // colour channels (B, G, R, A) in 16.16 at the first pixel and their x steps
+};
+
+// Skip the first 'n' pixels of a span
+static inline span_t span_advance(const span_t &s, int32_t n) {
+  span_t r = s;
+  r.dst += n;
+  r.count -= n;
+  r.x += float(n);
+  for (int k = 0; k < 3; k++)
+    r.e[k] = int32_t(uint32_t(s.e[k]) + uint32_t(s.de[k]) * uint32_t(n));
+  for (int k = 0; k < 4; k++)
+    r.col[k] = int32_t(uint32_t(s.col[k]) + uint32_t(s.dcol[k]) * uint32_t(n));
+  return r;
+}
+
+struct raster_kernels_t {
+  const char *name;
+  // [0] float edges, [1] fixed point edges
+  void (*solid[2])(const span_t &s, uint32_t colour);
+  void (*textured[2])(const span_t &s, const texture_t &tex, uint32_t colour);
+  void (*shaded[2])(const span_t &s);   // colour interpolated from the span colour channels
+  // rectangle spans, every pixel is covered
+  void (*fill)(uint32_t *dst, int32_t count, uint32_t colour);
+  void (*blit)(const span_t &s, const uint8_t *texels, int32_t width, uint32_t colour);
+  void (*glyph)(uint32_t *dst, const uint8_t *texels, int32_t count, uint32_t colour);    // texel i on pixel i
+  // layer rows, see raster_layer_t
+  void (*composite)(uint32_t *dst, const uint32_t *layer, int32_t count);
+};
+
+// sRGB <-> linear light conversion for the linear blends. Linear values have 12 bits,
+// enough for every 8 bit sRGB value to convert back to itself, and the weighted sums fit
+// the 16 bit multiplies of pmaddwd. The tables are padded for 32 bit gathers of their
+// last entry.
+static const int LINEAR_BITS = 12;
+
+struct linear_tables_t {
+  uint16_t to_linear[256 + 2];
+  uint8_t to_srgb[(1 << LINEAR_BITS) + 4];
+};
+
+static linear_tables_t make_linear_tables()
+{
+    linear_tables_t t = {};
+    const double scale = double((1 << LINEAR_BITS) - 1);
+    for (int i = 0; i < 256; i++) {
+        const double c = i / 255.0;
+        const double l = c <= 0.04045 ? c / 12.92 : pow((c + 0.055) / 1.055, 2.4);
+        t.to_linear[i] = uint16_t(l * scale + 0.5);
+    }
+    for (int i = 0; i < (1 << LINEAR_BITS); i++) {
+        const double l = i / scale;
+        const double c = l <= 0.0031308 ? l * 12.92 : 1.055 * pow(l, 1.0 / 2.4) - 0.055;
+        t.to_srgb[i] = uint8_t(c * 255.0 + 0.5);
+    }
+    return t;
+}
+
+static const linear_tables_t g_Linear = make_linear_tables();
+
+// round(x / 255) for x <= 255 * 255, also valid in each 16 bit lane of a word
+static inline uint32_t div255(uint32_t x) {
+  x += 0x80;
+  return (x + (x >> 8)) >> 8;
+}
+
+// blend_pixel() in linear light. The alpha goes to 0-256 so that 255 gives the source and
+// the sums need no division. The unused byte is blended as it is, like blend_pixel() does.
+static inline uint32_t blend_linear(uint32_t dst, uint32_t src, uint32_t a) {
+  const uint32_t w = a + (a >> 7), iw = 256 - w;
+  uint32_t out = ((((src >> 24) * w + (dst >> 24) * iw + 0x80) >> 8) << 24);
+  for (int shift = 0; shift < 24; shift += 8) {
+    const uint32_t l = g_Linear.to_linear[(src >> shift) & 0xff] * w + g_Linear.to_linear[(dst >> shift) & 0xff] * iw;
+    out |= uint32_t(g_Linear.to_srgb[(l + 0x80) >> 8]) << shift;
+  }
+  return out;
+}
+
+// A translucent fill blends one colour with one alpha, so each channel of the result only
+// depends on the same channel of the destination: fills in linear light look it up in a
+// table per channel, made for the colour by the drawing thread and kept until the next one.
+static const int32_t LINEAR_FILL_MIN = 64;  // pixels of a row worth making new tables for
+
+struct linear_fill_t {
+  uint32_t colour;                  // 0xAARRGGBB the tables are for
+  uint8_t channel[4][256 + 3];      // result per destination byte, padded for 32 bit gathers
+
+  uint32_t blend(uint32_t dst) const {
+    return uint32_t(channel[0][dst & 0xff]) | uint32_t(channel[1][(dst >> 8) & 0xff]) << 8 |
+           uint32_t(channel[2][(dst >> 16) & 0xff]) << 16 | uint32_t(channel[3][dst >> 24]) << 24;
+  }
+};
+
+static thread_local linear_fill_t g_LinearFill = { 0xffffffff, {} };   // opaque colours are never blended
+
+// Tables for filling 'count' pixels with 'colour', NULL if blending them one by one is cheaper
+static inline const linear_fill_t *linear_fill(uint32_t colour, int32_t count) {
+  linear_fill_t &f = g_LinearFill;
+  if (f.colour == colour)
+    return &f;
+  if (count < LINEAR_FILL_MIN)
+    return NULL;
+  f.colour = colour;
+  for (uint32_t d = 0; d < 256; d++) {
+    const uint32_t out = blend_linear(d * 0x01010101u, colour & 0xffffff, colour >> 24);
+    for (int k = 0; k < 4; k++)
+      f.channel[k][d] = uint8_t(out >> (k * 8));
+  }
+  return &f;
+}
+
+template <bool Linear>
+static inline uint32_t blend_pixel(uint32_t dst, uint32_t src, uint32_t a) {
+  if (Linear)
+    return blend_linear(dst, src, a);
+  const uint32_t ia = 255 - a;
+  uint32_t rb = (src & 0xff00ff) * a + (dst & 0xff00ff) * ia + 0x800080;
+  uint32_t ag = ((src >> 8) & 0xff00ff) * a + ((dst >> 8) & 0xff00ff) * ia + 0x800080;
+  rb = ((rb + ((rb >> 8) & 0xff00ff)) >> 8) & 0xff00ff;
+  ag = (ag + ((ag >> 8) & 0xff00ff)) & 0xff00ff00;
+  return rb | ag;
+}
+
+// Blend 'colour' with its alpha scaled by 'coverage' (a texel)
+template <bool Linear>
+static inline void blend_texel(uint32_t &dst, uint32_t colour, uint32_t texel) {
+  const uint32_t a = div255((colour >> 24) * texel);
+  if (a == 255)
+    dst = colour & 0xffffff;
+  else if (a != 0)
+    dst = blend_pixel<Linear>(dst, colour & 0xffffff, a);
+}
+
+// Coverage of pixel 'i' of a span
+template <bool Fixed>
+static inline bool span_covered(const span_t &s, int32_t i) {
+  if (Fixed) {
+    const uint32_t n = uint32_t(i);
+    return int32_t((uint32_t(s.e[0]) + uint32_t(s.de[0]) * n) |
+                   (uint32_t(s.e[1]) + uint32_t(s.de[1]) * n) |
+                   (uint32_t(s.e[2]) + uint32_t(s.de[2]) * n)) >= 0;
+  }
+  const float x = s.x + float(i);
+  return s.w[0] + s.dw[0] * x >= 0 && s.w[1] + s.dw[1] * x >= 0 && s.w[2] + s.dw[2] * x >= 0;
+}
+
+// Interpolated colour of pixel 'i' of a span. The channels are stepped in integers, with
+// wrapping 32 bit adds, so the value does not depend on where the span starts.
+static inline uint32_t span_colour(const span_t &s, int32_t i) {
+  uint32_t colour = 0;
+  for (int k = 0; k < 4; k++) {
+    const int32_t v = int32_t(uint32_t(s.col[k]) + uint32_t(s.dcol[k]) * uint32_t(i)) >> 16;
+    colour |= uint32_t(std::min(std::max(v, 0), 255)) << (k * 8);
+  }
+  return colour;
+}
+
+// Vertex colour times an 0xAARRGGBB texel, blended over 'dst'
+template <bool Linear>
+static inline void blend_modulated(uint32_t &dst, uint32_t colour, uint32_t texel) {
+  uint32_t src = 0;
+  for (int shift = 0; shift < 32; shift += 8)
+    src |= div255(((colour >> shift) & 0xff) * ((texel >> shift) & 0xff)) << shift;
+  const uint32_t a = src >> 24;
+  if (a == 255)
+    dst = src & 0xffffff;
+  else if (a != 0)
+    dst = blend_pixel<Linear>(dst, src & 0xffffff, a);
+}
+
+// Texture sampling. Coordinates are in texels, texel (i, j) covers [i, i + 1) x [j, j + 1).
+// Each combination of format, filter and addressing mode is its own sampler type so the
+// textured kernels are specialised for it; texture_t::sampler is the index of the combination.
+enum texture_format_e {
+  TEXTURE_A8,
+  TEXTURE_RGBA32,
+};
+
+static const uint32_t SAMPLER_BILINEAR = 2;
+
+static inline uint32_t texture_sampler(texture_format_e format, bool bilinear, bool wrap) {
+  return (format == TEXTURE_RGBA32 ? 4 : 0) | (bilinear ? SAMPLER_BILINEAR : 0) | (wrap ? 1 : 0);
+}
+
+// floorf() without the library call, for coordinates well within the int32_t range
+static inline int32_t floor_int(float f) {
+  f = std::min(std::max(f, -1e9f), 1e9f);
+  const int32_t i = int32_t(f);
+  return i - (float(i) > f ? 1 : 0);
+}
+
+template <bool Wrap>
+static inline int32_t texel_address(int32_t i, int32_t n) {
+  if (!Wrap)
+    return std::min(std::max(i, 0), n - 1);
+  if ((n & (n - 1)) == 0)
+    return i & (n - 1);
+  i %= n;
+  return i < 0 ? i + n : i;
+}
+
+// a + (b - a) * w / 256 in the 8 bit channels of a texel, 'w' in [0, 256]
+static inline uint32_t lerp_texel(uint32_t a, uint32_t b, uint32_t w) {
+  const uint32_t rb = (((a & 0xff00ff) * (256 - w) + (b & 0xff00ff) * w) >> 8) & 0xff00ff;
+  const uint32_t ag = (((a >> 8) & 0xff00ff) * (256 - w) + ((b >> 8) & 0xff00ff) * w) & 0xff00ff00;
+  return rb | ag;
+}
+
+template <texture_format_e Format>
+static inline uint32_t fetch_texel(const texture_t &tex, int32_t x, int32_t y) {
+  const uint8_t *p = tex.tex + y * tex.pitch;
+  if (Format == TEXTURE_A8)
+    return p[x];
+  p += x * 4;
+  // R, G, B, A in memory to 0xAARRGGBB
+  return (uint32_t(p[3]) << 24) | (uint32_t(p[0]) << 16) | (uint32_t(p[1]) << 8) | p[2];
+}
+
+// sample() returns the coverage (0-255) for TEXTURE_A8 and a 0xAARRGGBB texel otherwise
+template <texture_format_e Format, bool Bilinear, bool Wrap>
+struct sampler_t {
+  static const texture_format_e format = Format;
+  static const bool bilinear = Bilinear, wrap = Wrap;
+  static const bool alpha_only = Format == TEXTURE_A8;
+
+  static inline uint32_t sample(const texture_t &tex, float u, float v) {
+    if (!Bilinear)
+      return fetch_texel<Format>(tex, texel_address<Wrap>(floor_int(u), int32_t(tex.w)), texel_address<Wrap>(floor_int(v), int32_t(tex.h)));
+    uint32_t t[4], fu, fv;
+    taps(tex, u, v, t, fu, fv);
+    return lerp_texel(lerp_texel(t[0], t[1], fu), lerp_texel(t[2], t[3], fu), fv);
+  }
+
+  // The 4 texels around (u, v) (top left, top right, bottom left, bottom right) and the
+  // weights of the right and bottom ones in 1/256th, for bilinear filtering
+  static inline void taps(const texture_t &tex, float u, float v, uint32_t t[4], uint32_t &fu, uint32_t &fv) {
+    const int32_t w = int32_t(tex.w), h = int32_t(tex.h);
+    u -= .5f;
+    v -= .5f;
+    const int32_t iu = floor_int(u), iv = floor_int(v);
+    fu = uint32_t((u - float(iu)) * 256.f);
+    fv = uint32_t((v - float(iv)) * 256.f);
+    const int32_t x0 = texel_address<Wrap>(iu, w), x1 = texel_address<Wrap>(iu + 1, w);
+    const int32_t y0 = texel_address<Wrap>(iv, h), y1 = texel_address<Wrap>(iv + 1, h);
+    t[0] = fetch_texel<Format>(tex, x0, y0);
+    t[1] = fetch_texel<Format>(tex, x1, y0);
+    t[2] = fetch_texel<Format>(tex, x0, y1);
+    t[3] = fetch_texel<Format>(tex, x1, y1);
+  }
+
+  template <bool Linear>
+  static inline void blend(uint32_t &dst, uint32_t colour, uint32_t texel) {
+    if (alpha_only)
+      blend_texel<Linear>(dst, colour, texel);
+    else
+      blend_modulated<Linear>(dst, colour, texel);
+  }
+};
+
+// With ImGuiImplRasterTextureFlags_AutoFilter the filter follows the texel footprint of a
+// pixel (the UV derivatives, in texels per pixel): nearest where one texel maps to one
+// pixel, as for text at its rasterized size, bilinear where the texture is scaled or
+// rotated. The bilinear variant is made in 'filtered', which must outlive the drawing.
+static inline const texture_t &filter_texture(const texture_t &tex, float dudx, float dudy, float dvdx, float dvdy, texture_t &filtered)
+{
+    const float e = 1e-3f;
+    if (!tex.auto_filter || (tex.sampler & SAMPLER_BILINEAR) ||
+        (fabsf(fabsf(dudx) - 1.f) < e && fabsf(dudy) < e && fabsf(dvdx) < e && fabsf(fabsf(dvdy) - 1.f) < e))
+        return tex;
+    filtered = tex;
+    filtered.sampler |= SAMPLER_BILINEAR;
+    return filtered;
+}
+
+// Calls Kernel<Fixed, Linear, Sampler>::row() with the sampler of 'tex'. Picking the sampler
+// once per row keeps the per pixel loops free of format and addressing mode tests.
+template <template <bool, bool, class> class Kernel, bool Fixed, bool Linear>
+static void textured_dispatch(const span_t &s, const texture_t &tex, uint32_t colour)
+{
+    switch (tex.sampler) {
+    case 0: Kernel<Fixed, Linear, sampler_t<TEXTURE_A8, false, false> >::row(s, tex, colour); break;
+    case 1: Kernel<Fixed, Linear, sampler_t<TEXTURE_A8, false, true> >::row(s, tex, colour); break;
+    case 2: Kernel<Fixed, Linear, sampler_t<TEXTURE_A8, true, false> >::row(s, tex, colour); break;
+    case 3: Kernel<Fixed, Linear, sampler_t<TEXTURE_A8, true, true> >::row(s, tex, colour); break;
+    case 4: Kernel<Fixed, Linear, sampler_t<TEXTURE_RGBA32, false, false> >::row(s, tex, colour); break;
+    case 5: Kernel<Fixed, Linear, sampler_t<TEXTURE_RGBA32, false, true> >::row(s, tex, colour); break;
+    case 6: Kernel<Fixed, Linear, sampler_t<TEXTURE_RGBA32, true, false> >::row(s, tex, colour); break;
+    case 7: Kernel<Fixed, Linear, sampler_t<TEXTURE_RGBA32, true, true> >::row(s, tex, colour); break;
+    }
+}
+
+template <bool Fixed, bool Linear>
+static void solid_row_scalar(const span_t &s, uint32_t colour)
+{
+    const uint32_t a = colour >> 24;
+    const uint32_t rgb = colour & 0xffffff;
+    if (const linear_fill_t *fill = (Linear && a != 255) ? linear_fill(colour, s.count) : NULL) {
+        for (int32_t i = 0; i < s.count; i++)
+            if (span_covered<Fixed>(s, i))
+                s.dst[i] = fill->blend(s.dst[i]);
+        return;
+    }
+    for (int32_t i = 0; i < s.count; i++) {
+        // If p is on or inside all edges, render pixel
+        if (span_covered<Fixed>(s, i))
+            s.dst[i] = (a == 255) ? rgb : blend_pixel<Linear>(s.dst[i], rgb, a);
+    }
+}
+
+template <bool Fixed, bool Linear>
+static void shaded_row_scalar(const span_t &s)
+{
+    for (int32_t i = 0; i < s.count; i++) {
+        if (!span_covered<Fixed>(s, i))
+            continue;
+        const uint32_t colour = span_colour(s, i);
+        const uint32_t a = colour >> 24;
+        if (a == 255)
+            s.dst[i] = colour & 0xffffff;
+        else if (a != 0)
+            s.dst[i] = blend_pixel<Linear>(s.dst[i], colour & 0xffffff, a);
+    }
+}
+
+template <bool Fixed, bool Linear, class Sampler>
+struct textured_scalar_t {
+  static void row(const span_t &s, const texture_t &tex, uint32_t colour)
+  {
+      for (int32_t i = 0; i < s.count; i++) {
+          if (!span_covered<Fixed>(s, i))
+              continue;
+          const float x = s.x + float(i);
+          Sampler::template blend<Linear>(s.dst[i], colour, Sampler::sample(tex, s.u + s.du * x, s.v + s.dv * x));
+      }
+  }
+};
+
+template <bool Linear>
+static void fill_row_scalar(uint32_t *dst, int32_t count, uint32_t colour)
+{
+    const uint32_t a = colour >> 24;
+    if (a == 255) {
+        std::fill_n(dst, count, colour & 0xffffff);
+        return;
+    }
+    if (const linear_fill_t *fill = Linear ? linear_fill(colour, count) : NULL) {
+        for (int32_t i = 0; i < count; i++)
+            dst[i] = fill->blend(dst[i]);
+        return;
+    }
+    for (int32_t i = 0; i < count; i++)
+        dst[i] = blend_pixel<Linear>(dst[i], colour & 0xffffff, a);
+}
+
+// 's.u' and 's.du' index into 'texels', a single row of the texture
+template <bool Linear>
+static void blit_row_scalar(const span_t &s, const uint8_t *texels, int32_t width, uint32_t colour)
+{
+    const float umax = float(width - 1);
+    for (int32_t i = 0; i < s.count; i++) {
+        const float u = std::min(std::max(s.u + s.du * (s.x + float(i)), 0.f), umax);
+        blend_texel<Linear>(s.dst[i], colour, texels[int32_t(u)]);
+    }
+}
+
+template <bool Linear>
+static void glyph_row_scalar(uint32_t *dst, const uint8_t *texels, int32_t count, uint32_t colour)
+{
+    for (int32_t i = 0; i < count; i++)
+        blend_texel<Linear>(dst[i], colour, texels[i]);
+}
+
+// dst = colour + transmittance * dst / 255 for each colour channel, the unused byte is kept
+static void composite_row_scalar(uint32_t *dst, const uint32_t *layer, int32_t count)
+{
+    for (int32_t i = 0; i < count; i++) {
+        const uint32_t l = layer[i], t = l >> 24, d = dst[i];
+        // nothing drawn there
+        if (t == 255 && (l & 0xffffff) == 0)
+            continue;
+        uint32_t out = d & 0xff000000;
+        for (int shift = 0; shift < 24; shift += 8)
+            out |= std::min(((l >> shift) & 0xff) + div255(t * ((d >> shift) & 0xff)), 255u) << shift;
+        dst[i] = out;
+    }
+}
+
+static const raster_kernels_t g_kernels_scalar = {
+  "scalar",
+  { solid_row_scalar<false, false>, solid_row_scalar<true, false> },
+  { textured_dispatch<textured_scalar_t, false, false>, textured_dispatch<textured_scalar_t, true, false> },
+  { shaded_row_scalar<false, false>, shaded_row_scalar<true, false> },
+  fill_row_scalar<false>, blit_row_scalar<false>, glyph_row_scalar<false>, composite_row_scalar
+};
+
+// Layers are not drawn in linear light, their composite is only there to fill the table
+static const raster_kernels_t g_kernels_scalar_linear = {
+  "scalar linear",
+  { solid_row_scalar<false, true>, solid_row_scalar<true, true> },
+  { textured_dispatch<textured_scalar_t, false, true>, textured_dispatch<textured_scalar_t, true, true> },
+  { shaded_row_scalar<false, true>, shaded_row_scalar<true, true> },
+  fill_row_scalar<true>, blit_row_scalar<true>, glyph_row_scalar<true>, composite_row_scalar
+};
+
+#if defined(IMGUI_IMPL_RASTER_SSE2)
+
+static inline __m128 span_mask_sse2(const span_t &s, __m128 x) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 e0 = _mm_add_ps(_mm_set1_ps(s.w[0]), _mm_mul_ps(_mm_set1_ps(s.dw[0]), x));
+    const __m128 e1 = _mm_add_ps(_mm_set1_ps(s.w[1]), _mm_mul_ps(_mm_set1_ps(s.dw[1]), x));
+    const __m128 e2 = _mm_add_ps(_mm_set1_ps(s.w[2]), _mm_mul_ps(_mm_set1_ps(s.dw[2]), x));
+    return _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+}
+
+// Coverage of 4 consecutive pixels, walking a span from its start
+template <bool Fixed>
+struct coverage_sse2_t {
+  const span_t &s;
+  __m128 x;
+  __m128i e[3], de[3];
+
+  coverage_sse2_t(const span_t &span) : s(span) {
+    x = _mm_add_ps(_mm_set1_ps(s.x), _mm_setr_ps(0.f, 1.f, 2.f, 3.f));
+    if (Fixed) {
+      for (int k = 0; k < 3; k++) {
+        const uint32_t e0 = uint32_t(s.e[k]), d = uint32_t(s.de[k]);
+        e[k] = _mm_setr_epi32(int(e0), int(e0 + d), int(e0 + d * 2), int(e0 + d * 3));
+        de[k] = _mm_set1_epi32(int(d * 4));
+      }
+    }
+  }
+
+  __m128 mask() const {
+    if (Fixed) {
+      const __m128i any = _mm_or_si128(_mm_or_si128(e[0], e[1]), e[2]);
+      return _mm_castsi128_ps(_mm_cmpgt_epi32(any, _mm_set1_epi32(-1)));
+    }
+    return span_mask_sse2(s, x);
+  }
+
+  void step() {
+    x = _mm_add_ps(x, _mm_set1_ps(4.f));
+    if (Fixed) {
+      for (int k = 0; k < 3; k++)
+        e[k] = _mm_add_epi32(e[k], de[k]);
+    }
+  }
+};
+
+static inline void store_masked_sse2(uint32_t *dst, __m128i mask, __m128i colour) {
+    const __m128i d = _mm_loadu_si128((const __m128i*)dst);
+    _mm_storeu_si128((__m128i*)dst, _mm_or_si128(_mm_and_si128(mask, colour), _mm_andnot_si128(mask, d)));
+}
+
+// round(x / 255) in each 16 bit lane
+static inline __m128i div255_sse2(__m128i x) {
+    x = _mm_add_epi16(x, _mm_set1_epi16(0x80));
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+// blend_linear() of 4 pixels. SSE2 has no gather, so the table lookups are done one value
+// at a time, the weighted sums with pmaddwd on (source, destination) pairs.
+static inline __m128i blend_linear_sse2(__m128i dst, __m128i src, __m128i alpha) {
+    alignas(16) uint32_t d[4], c[4];
+    alignas(16) uint16_t pairs[4][8];   // per pixel, B, G, R and the unused byte
+    alignas(16) int32_t l[4][4];
+    _mm_store_si128((__m128i*)d, dst);
+    _mm_store_si128((__m128i*)c, src);
+    for (int k = 0; k < 4; k++) {
+        for (int j = 0; j < 3; j++) {
+            pairs[k][j * 2] = g_Linear.to_linear[(c[k] >> (j * 8)) & 0xff];
+            pairs[k][j * 2 + 1] = g_Linear.to_linear[(d[k] >> (j * 8)) & 0xff];
+        }
+        pairs[k][6] = uint16_t(c[k] >> 24);
+        pairs[k][7] = uint16_t(d[k] >> 24);
+    }
+    // (w, 256 - w) in each 32 bit lane, then broadcast per pixel
+    const __m128i w = _mm_add_epi32(alpha, _mm_srli_epi32(alpha, 7));
+    const __m128i pw = _mm_or_si128(w, _mm_slli_epi32(_mm_sub_epi32(_mm_set1_epi32(256), w), 16));
+    const __m128i weights[4] = {
+        _mm_shuffle_epi32(pw, 0x00), _mm_shuffle_epi32(pw, 0x55), _mm_shuffle_epi32(pw, 0xaa), _mm_shuffle_epi32(pw, 0xff) };
+    for (int k = 0; k < 4; k++)
+        _mm_store_si128((__m128i*)l[k], _mm_srli_epi32(_mm_add_epi32(
+            _mm_madd_epi16(_mm_load_si128((const __m128i*)pairs[k]), weights[k]), _mm_set1_epi32(0x80)), 8));
+    for (int k = 0; k < 4; k++)
+        c[k] = uint32_t(g_Linear.to_srgb[l[k][0]]) | uint32_t(g_Linear.to_srgb[l[k][1]]) << 8 |
+               uint32_t(g_Linear.to_srgb[l[k][2]]) << 16 | uint32_t(l[k][3]) << 24;
+    return _mm_load_si128((const __m128i*)c);
+}
+
+// Blend 4 pixels, 'alpha' holds one 0-255 value per 32 bit lane
+template <bool Linear>
+static inline __m128i blend_sse2(__m128i dst, __m128i src, __m128i alpha) {
+    if (Linear)
+        return blend_linear_sse2(dst, src, alpha);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i a2 = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 16));
+    const __m128i alo = _mm_unpacklo_epi32(a2, a2), ahi = _mm_unpackhi_epi32(a2, a2);
+    const __m128i ialo = _mm_sub_epi16(_mm_set1_epi16(255), alo), iahi = _mm_sub_epi16(_mm_set1_epi16(255), ahi);
+    const __m128i lo = _mm_add_epi16(
+        _mm_mullo_epi16(_mm_unpacklo_epi8(src, zero), alo), _mm_mullo_epi16(_mm_unpacklo_epi8(dst, zero), ialo));
+    const __m128i hi = _mm_add_epi16(
+        _mm_mullo_epi16(_mm_unpackhi_epi8(src, zero), ahi), _mm_mullo_epi16(_mm_unpackhi_epi8(dst, zero), iahi));
+    return _mm_packus_epi16(div255_sse2(lo), div255_sse2(hi));
+}
+
+// Texels scaled by the colour alpha, one per 32 bit lane
+static inline __m128i texel_alpha_sse2(__m128i texels, uint32_t colour) {
+    return div255_sse2(_mm_mullo_epi16(texels, _mm_set1_epi32(int(colour >> 24))));
+}
+
+// Blend the vertex colour times 4 texels (alpha_only: 4 coverage values) over 'dst'
+template <bool Linear, class Sampler>
+static inline __m128i blend_texels_sse2(__m128i dst, __m128i texels, uint32_t colour) {
+    if (Sampler::alpha_only)
+        return blend_sse2<Linear>(dst, _mm_set1_epi32(int(colour & 0xffffff)), texel_alpha_sse2(texels, colour));
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i c = _mm_unpacklo_epi8(_mm_set1_epi32(int(colour)), zero);
+    const __m128i src = _mm_packus_epi16(
+        div255_sse2(_mm_mullo_epi16(_mm_unpacklo_epi8(texels, zero), c)),
+        div255_sse2(_mm_mullo_epi16(_mm_unpackhi_epi8(texels, zero), c)));
+    return blend_sse2<Linear>(dst, _mm_and_si128(src, _mm_set1_epi32(0xffffff)), _mm_srli_epi32(src, 24));
+}
+
+// lerp_texel() of 4 texels, 'w' in [0, 256] per 32 bit lane. The 16 bit products and their
+// sum stay below 255 * 256, so the result is the same as the scalar one.
+static inline __m128i lerp_texels_sse2(__m128i a, __m128i b, __m128i w) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i w2 = _mm_or_si128(w, _mm_slli_epi32(w, 16));
+    const __m128i wlo = _mm_unpacklo_epi32(w2, w2), whi = _mm_unpackhi_epi32(w2, w2);
+    const __m128i iwlo = _mm_sub_epi16(_mm_set1_epi16(256), wlo), iwhi = _mm_sub_epi16(_mm_set1_epi16(256), whi);
+    const __m128i lo = _mm_add_epi16(
+        _mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), iwlo), _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), wlo));
+    const __m128i hi = _mm_add_epi16(
+        _mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), iwhi), _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), whi));
+    return _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8));
+}
+
+template <bool Fixed, bool Linear>
+static void solid_row_sse2(const span_t &s, uint32_t colour)
+{
+    const __m128i c = _mm_set1_epi32(int(colour & 0xffffff));
+    const __m128i a = _mm_set1_epi32(int(colour >> 24));
+    const bool opaque = (colour >> 24) == 255;
+    coverage_sse2_t<Fixed> cover(s);
+    bool inside = false;
+    int32_t i = 0;
+    // whole groups of 4, the tail is left to the scalar kernel so we never touch
+    // pixels past the span (they may belong to a tile owned by another thread)
+    for (; i + 4 <= s.count; i += 4) {
+        const __m128 m = cover.mask();
+        cover.step();
+        if (_mm_movemask_ps(m) == 0) {
+            // triangles are convex, once we leave the span we are done
+            if (inside)
+                return;
+            continue;
+        }
+        inside = true;
+        if (opaque)
+            store_masked_sse2(s.dst + i, _mm_castps_si128(m), c);
+        else
+            store_masked_sse2(s.dst + i, _mm_castps_si128(m),
+                blend_sse2<Linear>(_mm_loadu_si128((const __m128i*)(s.dst + i)), c, a));
+    }
+    solid_row_scalar<Fixed, Linear>(span_advance(s, i), colour);
+}
+
+// Interpolated colours of 4 consecutive pixels
+struct colour_sse2_t {
+  __m128i c[4], dc[4];
+
+  colour_sse2_t(const span_t &s) {
+    for (int k = 0; k < 4; k++) {
+      const uint32_t c0 = uint32_t(s.col[k]), d = uint32_t(s.dcol[k]);
+      c[k] = _mm_setr_epi32(int(c0), int(c0 + d), int(c0 + d * 2), int(c0 + d * 3));
+      dc[k] = _mm_set1_epi32(int(d * 4));
+    }
+  }
+
+  // 0xAARRGGBB pixels, the saturating packs clamp the channels like span_colour()
+  __m128i pixels() const {
+    const __m128i bg = _mm_packs_epi32(_mm_srai_epi32(c[0], 16), _mm_srai_epi32(c[1], 16));
+    const __m128i ra = _mm_packs_epi32(_mm_srai_epi32(c[2], 16), _mm_srai_epi32(c[3], 16));
+    const __m128i p = _mm_packus_epi16(bg, ra);   // B0..B3 G0..G3 R0..R3 A0..A3
+    const __m128i q = _mm_srli_si128(p, 8);
+    return _mm_unpacklo_epi16(
+        _mm_unpacklo_epi8(p, _mm_srli_si128(p, 4)), _mm_unpacklo_epi8(q, _mm_srli_si128(q, 4)));
+  }
+
+  void step() {
+    for (int k = 0; k < 4; k++)
+      c[k] = _mm_add_epi32(c[k], dc[k]);
+  }
+};
+
+template <bool Fixed, bool Linear>
+static void shaded_row_sse2(const span_t &s)
+{
+    coverage_sse2_t<Fixed> cover(s);
+    colour_sse2_t colour(s);
+    bool inside = false;
+    int32_t i = 0;
+    for (; i + 4 <= s.count; i += 4, cover.step(), colour.step()) {
+        const __m128 m = cover.mask();
+        if (_mm_movemask_ps(m) == 0) {
+            if (inside)
+                return;
+            continue;
+        }
+        inside = true;
+        const __m128i c = colour.pixels();
+        store_masked_sse2(s.dst + i, _mm_castps_si128(m), blend_sse2<Linear>(_mm_loadu_si128((const __m128i*)(s.dst + i)),
+            _mm_and_si128(c, _mm_set1_epi32(0xffffff)), _mm_srli_epi32(c, 24)));
+    }
+    shaded_row_scalar<Fixed, Linear>(span_advance(s, i));
+}
+
+template <bool Fixed, bool Linear, class Sampler>
+struct textured_sse2_t {
+  static void row(const span_t &s, const texture_t &tex, uint32_t colour)
+  {
+      coverage_sse2_t<Fixed> cover(s);
+      bool inside = false;
+      int32_t i = 0;
+      for (; i + 4 <= s.count; i += 4, cover.step()) {
+          const __m128 m = cover.mask();
+          if (_mm_movemask_ps(m) == 0) {
+              if (inside)
+                  return;
+              continue;
+          }
+          inside = true;
+          // texel fetch has no SSE2 equivalent, coordinates are computed wide and sampled by hand
+          alignas(16) float u[4], v[4];
+          alignas(16) uint32_t t[4];
+          _mm_store_ps(u, _mm_add_ps(_mm_set1_ps(s.u), _mm_mul_ps(_mm_set1_ps(s.du), cover.x)));
+          _mm_store_ps(v, _mm_add_ps(_mm_set1_ps(s.v), _mm_mul_ps(_mm_set1_ps(s.dv), cover.x)));
+          __m128i texels;
+          if (Sampler::bilinear) {
+              // fetch the taps by hand, filter the 4 pixels at once
+              alignas(16) uint32_t taps[4][4], fu[4], fv[4];
+              uint32_t tk[4];
+              for (int k = 0; k < 4; k++) {
+                  Sampler::taps(tex, u[k], v[k], tk, fu[k], fv[k]);
+                  for (int j = 0; j < 4; j++)
+                      taps[j][k] = tk[j];
+              }
+              const __m128i wu = _mm_load_si128((const __m128i*)fu);
+              texels = lerp_texels_sse2(
+                  lerp_texels_sse2(_mm_load_si128((const __m128i*)taps[0]), _mm_load_si128((const __m128i*)taps[1]), wu),
+                  lerp_texels_sse2(_mm_load_si128((const __m128i*)taps[2]), _mm_load_si128((const __m128i*)taps[3]), wu),
+                  _mm_load_si128((const __m128i*)fv));
+          } else {
+              for (int k = 0; k < 4; k++)
+                  t[k] = Sampler::sample(tex, u[k], v[k]);
+              texels = _mm_load_si128((const __m128i*)t);
+          }
+          store_masked_sse2(s.dst + i, _mm_castps_si128(m), blend_texels_sse2<Linear, Sampler>(
+              _mm_loadu_si128((const __m128i*)(s.dst + i)), texels, colour));
+      }
+      textured_scalar_t<Fixed, Linear, Sampler>::row(span_advance(s, i), tex, colour);
+  }
+};
+
+// Linear light fills are table lookups, which SSE2 cannot do any faster than the scalar code
+template <bool Linear>
+static void fill_row_sse2(uint32_t *dst, int32_t count, uint32_t colour)
+{
+    if (Linear && (colour >> 24) != 255) {
+        fill_row_scalar<Linear>(dst, count, colour);
+        return;
+    }
+    const __m128i c = _mm_set1_epi32(int(colour & 0xffffff));
+    const __m128i a = _mm_set1_epi32(int(colour >> 24));
+    const bool opaque = (colour >> 24) == 255;
+    int32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i *p = (__m128i*)(dst + i);
+        _mm_storeu_si128(p, opaque ? c : blend_sse2<Linear>(_mm_loadu_si128(p), c, a));
+    }
+    fill_row_scalar<Linear>(dst + i, count - i, colour);
+}
+
+template <bool Linear>
+static void blit_row_sse2(const span_t &s, const uint8_t *texels, int32_t width, uint32_t colour)
+{
+    const __m128i c = _mm_set1_epi32(int(colour & 0xffffff));
+    const __m128 umax = _mm_set1_ps(float(width - 1));
+    __m128 x = _mm_add_ps(_mm_set1_ps(s.x), _mm_setr_ps(0.f, 1.f, 2.f, 3.f));
+    int32_t i = 0;
+    for (; i + 4 <= s.count; i += 4) {
+        const __m128 u = _mm_add_ps(_mm_set1_ps(s.u), _mm_mul_ps(_mm_set1_ps(s.du), x));
+        alignas(16) int32_t iu[4], t[4];
+        _mm_store_si128((__m128i*)iu, _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(u, _mm_setzero_ps()), umax)));
+        for (int k = 0; k < 4; k++)
+            t[k] = texels[iu[k]];
+        const __m128i a = texel_alpha_sse2(_mm_load_si128((const __m128i*)t), colour);
+        __m128i *p = (__m128i*)(s.dst + i);
+        _mm_storeu_si128(p, blend_sse2<Linear>(_mm_loadu_si128(p), c, a));
+        x = _mm_add_ps(x, _mm_set1_ps(4.f));
+    }
+    blit_row_scalar<Linear>(span_advance(s, i), texels, width, colour);
+}
+
+template <bool Linear>
+static void glyph_row_sse2(uint32_t *dst, const uint8_t *texels, int32_t count, uint32_t colour)
+{
+    const __m128i c = _mm_set1_epi32(int(colour & 0xffffff));
+    const __m128i zero = _mm_setzero_si128();
+    int32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        int32_t t;
+        memcpy(&t, texels + i, 4);
+        // most of a glyph box is empty
+        if (t == 0)
+            continue;
+        const __m128i a = texel_alpha_sse2(_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(t), zero), zero), colour);
+        __m128i *p = (__m128i*)(dst + i);
+        _mm_storeu_si128(p, blend_sse2<Linear>(_mm_loadu_si128(p), c, a));
+    }
+    glyph_row_scalar<Linear>(dst + i, texels + i, count - i, colour);
+}
+
+static void composite_row_sse2(uint32_t *dst, const uint32_t *layer, int32_t count)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i rgb = _mm_set1_epi32(0xffffff);
+    const __m128i empty = _mm_set1_epi32(int(0xff000000));
+    int32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i l = _mm_loadu_si128((const __m128i*)(layer + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(l, empty)) == 0xffff)
+            continue;
+        __m128i *p = (__m128i*)(dst + i);
+        const __m128i d = _mm_loadu_si128(p);
+        // the transmittance in the four 16 bit lanes of each pixel
+        const __m128i t = _mm_srli_epi32(l, 24);
+        const __m128i t2 = _mm_or_si128(t, _mm_slli_epi32(t, 16));
+        const __m128i lo = div255_sse2(_mm_mullo_epi16(_mm_unpacklo_epi32(t2, t2), _mm_unpacklo_epi8(d, zero)));
+        const __m128i hi = div255_sse2(_mm_mullo_epi16(_mm_unpackhi_epi32(t2, t2), _mm_unpackhi_epi8(d, zero)));
+        const __m128i c = _mm_adds_epu8(l, _mm_packus_epi16(lo, hi));
+        _mm_storeu_si128(p, _mm_or_si128(_mm_and_si128(c, rgb), _mm_andnot_si128(rgb, d)));
+    }
+    composite_row_scalar(dst + i, layer + i, count - i);
+}
+
+static const raster_kernels_t g_kernels_sse2 = {
+  "sse2",
+  { solid_row_sse2<false, false>, solid_row_sse2<true, false> },
+  { textured_dispatch<textured_sse2_t, false, false>, textured_dispatch<textured_sse2_t, true, false> },
+  { shaded_row_sse2<false, false>, shaded_row_sse2<true, false> },
+  fill_row_sse2<false>, blit_row_sse2<false>, glyph_row_sse2<false>, composite_row_sse2
+};
+
+static const raster_kernels_t g_kernels_sse2_linear = {
+  "sse2 linear",
+  { solid_row_sse2<false, true>, solid_row_sse2<true, true> },
+  { textured_dispatch<textured_sse2_t, false, true>, textured_dispatch<textured_sse2_t, true, true> },
+  { shaded_row_sse2<false, true>, shaded_row_sse2<true, true> },
+  fill_row_sse2<true>, blit_row_sse2<true>, glyph_row_sse2<true>, composite_row_sse2
+};
+
+#endif // IMGUI_IMPL_RASTER_SSE2
+
+#if defined(IMGUI_IMPL_RASTER_AVX2)
+
+RASTER_TARGET_AVX2 static inline __m256 span_mask_avx2(const span_t &s, __m256 x) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 e0 = _mm256_add_ps(_mm256_set1_ps(s.w[0]), _mm256_mul_ps(_mm256_set1_ps(s.dw[0]), x));
+    const __m256 e1 = _mm256_add_ps(_mm256_set1_ps(s.w[1]), _mm256_mul_ps(_mm256_set1_ps(s.dw[1]), x));
+    const __m256 e2 = _mm256_add_ps(_mm256_set1_ps(s.w[2]), _mm256_mul_ps(_mm256_set1_ps(s.dw[2]), x));
+    return _mm256_and_ps(_mm256_and_ps(
+        _mm256_cmp_ps(e0, zero, _CMP_GE_OQ), _mm256_cmp_ps(e1, zero, _CMP_GE_OQ)), _mm256_cmp_ps(e2, zero, _CMP_GE_OQ));
+}
+
+// Coverage of 8 consecutive pixels, as coverage_sse2_t
+template <bool Fixed>
+struct coverage_avx2_t {
+  const span_t &s;
+  __m256 x;
+  __m256i e[3], de[3];
+
+  RASTER_TARGET_AVX2 coverage_avx2_t(const span_t &span) : s(span) {
+    x = _mm256_add_ps(_mm256_set1_ps(s.x), _mm256_setr_ps(0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f));
+    if (Fixed) {
+      for (int k = 0; k < 3; k++) {
+        const __m256i d = _mm256_set1_epi32(s.de[k]);
+        e[k] = _mm256_add_epi32(_mm256_set1_epi32(s.e[k]),
+                                _mm256_mullo_epi32(d, _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)));
+        de[k] = _mm256_slli_epi32(d, 3);
+      }
+    }
+  }
+
+  RASTER_TARGET_AVX2 __m256i mask() const {
+    if (Fixed) {
+      const __m256i any = _mm256_or_si256(_mm256_or_si256(e[0], e[1]), e[2]);
+      return _mm256_cmpgt_epi32(any, _mm256_set1_epi32(-1));
+    }
+    return _mm256_castps_si256(span_mask_avx2(s, x));
+  }
+
+  RASTER_TARGET_AVX2 void step() {
+    x = _mm256_add_ps(x, _mm256_set1_ps(8.f));
+    if (Fixed) {
+      for (int k = 0; k < 3; k++)
+        e[k] = _mm256_add_epi32(e[k], de[k]);
+    }
+  }
+};
+
+// Lanes at or past 'count' are masked off, maskstore leaves them untouched
+RASTER_TARGET_AVX2 static inline __m256i tail_mask_avx2(int32_t count) {
+    return _mm256_cmpgt_epi32(_mm256_set1_epi32(count), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+RASTER_TARGET_AVX2 static inline __m256i div255_avx2(__m256i x) {
+    x = _mm256_add_epi16(x, _mm256_set1_epi16(0x80));
+    return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+}
+
+// Channel 'Shift' of 8 pixels in linear light, gathered from the 16 bit table
+template <int Shift>
+RASTER_TARGET_AVX2 static inline __m256i to_linear_avx2(__m256i p) {
+    const __m256i c = _mm256_and_si256(_mm256_srli_epi32(p, Shift), _mm256_set1_epi32(0xff));
+    return _mm256_and_si256(_mm256_i32gather_epi32((const int*)g_Linear.to_linear, c, 2), _mm256_set1_epi32(0xffff));
+}
+
+// Channel 'Shift' of 8 pixels blended in linear light and gathered back to sRGB
+template <int Shift>
+RASTER_TARGET_AVX2 static inline __m256i blend_channel_avx2(__m256i dst, __m256i src, __m256i weights) {
+    const __m256i pair = _mm256_or_si256(to_linear_avx2<Shift>(src), _mm256_slli_epi32(to_linear_avx2<Shift>(dst), 16));
+    const __m256i l = _mm256_srli_epi32(_mm256_add_epi32(_mm256_madd_epi16(pair, weights), _mm256_set1_epi32(0x80)), 8);
+    const __m256i c = _mm256_i32gather_epi32((const int*)g_Linear.to_srgb, l, 1);
+    return _mm256_slli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0xff)), Shift);
+}
+
+// blend_linear() of 8 pixels, the weighted sums with pmaddwd as in blend_linear_sse2()
+RASTER_TARGET_AVX2 static inline __m256i blend_linear_avx2(__m256i dst, __m256i src, __m256i alpha) {
+    const __m256i w = _mm256_add_epi32(alpha, _mm256_srli_epi32(alpha, 7));
+    const __m256i weights = _mm256_or_si256(w, _mm256_slli_epi32(_mm256_sub_epi32(_mm256_set1_epi32(256), w), 16));
+    const __m256i x = _mm256_or_si256(_mm256_srli_epi32(src, 24), _mm256_slli_epi32(_mm256_srli_epi32(dst, 24), 16));
+    const __m256i unused = _mm256_srli_epi32(_mm256_add_epi32(_mm256_madd_epi16(x, weights), _mm256_set1_epi32(0x80)), 8);
+    return _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(unused, 24), blend_channel_avx2<0>(dst, src, weights)),
+        _mm256_or_si256(blend_channel_avx2<8>(dst, src, weights), blend_channel_avx2<16>(dst, src, weights)));
+}
+
+// Same as blend_sse2, unpack and pack work within 128 bit lanes so the pixel order is kept
+template <bool Linear>
+RASTER_TARGET_AVX2 static inline __m256i blend_avx2(__m256i dst, __m256i src, __m256i alpha) {
+    if (Linear)
+        return blend_linear_avx2(dst, src, alpha);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i a2 = _mm256_or_si256(alpha, _mm256_slli_epi32(alpha, 16));
+    const __m256i alo = _mm256_unpacklo_epi32(a2, a2), ahi = _mm256_unpackhi_epi32(a2, a2);
+    const __m256i ialo = _mm256_sub_epi16(_mm256_set1_epi16(255), alo), iahi = _mm256_sub_epi16(_mm256_set1_epi16(255), ahi);
+    const __m256i lo = _mm256_add_epi16(
+        _mm256_mullo_epi16(_mm256_unpacklo_epi8(src, zero), alo), _mm256_mullo_epi16(_mm256_unpacklo_epi8(dst, zero), ialo));
+    const __m256i hi = _mm256_add_epi16(
+        _mm256_mullo_epi16(_mm256_unpackhi_epi8(src, zero), ahi), _mm256_mullo_epi16(_mm256_unpackhi_epi8(dst, zero), iahi));
+    return _mm256_packus_epi16(div255_avx2(lo), div255_avx2(hi));
+}
+
+// linear_fill_t::blend() of 8 pixels, one gather per channel
+RASTER_TARGET_AVX2 static inline __m256i linear_fill_avx2(const linear_fill_t &f, __m256i dst) {
+    const __m256i byte = _mm256_set1_epi32(0xff);
+    const __m256i b = _mm256_i32gather_epi32((const int*)f.channel[0], _mm256_and_si256(dst, byte), 1);
+    const __m256i g = _mm256_i32gather_epi32((const int*)f.channel[1], _mm256_and_si256(_mm256_srli_epi32(dst, 8), byte), 1);
+    const __m256i r = _mm256_i32gather_epi32((const int*)f.channel[2], _mm256_and_si256(_mm256_srli_epi32(dst, 16), byte), 1);
+    const __m256i x = _mm256_i32gather_epi32((const int*)f.channel[3], _mm256_srli_epi32(dst, 24), 1);
+    return _mm256_or_si256(
+        _mm256_or_si256(_mm256_and_si256(b, byte), _mm256_slli_epi32(_mm256_and_si256(g, byte), 8)),
+        _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(r, byte), 16), _mm256_slli_epi32(x, 24)));
+}
+
+RASTER_TARGET_AVX2 static inline __m256i texel_alpha_avx2(__m256i texels, uint32_t colour) {
+    return div255_avx2(_mm256_mullo_epi16(texels, _mm256_set1_epi32(int(colour >> 24))));
+}
+
+template <bool Fixed, bool Linear>
+RASTER_TARGET_AVX2 static void solid_row_avx2(const span_t &s, uint32_t colour)
+{
+    const __m256i c = _mm256_set1_epi32(int(colour & 0xffffff));
+    const __m256i a = _mm256_set1_epi32(int(colour >> 24));
+    const bool opaque = (colour >> 24) == 255;
+    const linear_fill_t *fill = (Linear && !opaque) ? linear_fill(colour, s.count) : NULL;
+    coverage_avx2_t<Fixed> cover(s);
+    bool inside = false;
+    for (int32_t i = 0; i < s.count; i += 8) {
+        __m256i m = cover.mask();
+        cover.step();
+        if (i + 8 > s.count)
+            m = _mm256_and_si256(m, tail_mask_avx2(s.count - i));
+        if (_mm256_testz_si256(m, m)) {
+            if (inside)
+                return;
+            continue;
+        }
+        inside = true;
+        int *p = (int*)(s.dst + i);
+        const __m256i d = _mm256_maskload_epi32(p, m);
+        _mm256_maskstore_epi32(p, m, opaque ? c : fill ? linear_fill_avx2(*fill, d) : blend_avx2<Linear>(d, c, a));
+    }
+}
+
+// Interpolated colours of 8 consecutive pixels, as colour_sse2_t. Pack and unpack work
+// within 128 bit lanes, which then hold pixels 0-3 and 4-7 in order.
+struct colour_avx2_t {
+  __m256i c[4], dc[4];
+
+  RASTER_TARGET_AVX2 colour_avx2_t(const span_t &s) {
+    for (int k = 0; k < 4; k++) {
+      const __m256i d = _mm256_set1_epi32(s.dcol[k]);
+      c[k] = _mm256_add_epi32(_mm256_set1_epi32(s.col[k]), _mm256_mullo_epi32(d, _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)));
+      dc[k] = _mm256_slli_epi32(d, 3);
+    }
+  }
+
+  RASTER_TARGET_AVX2 __m256i pixels() const {
+    const __m256i bg = _mm256_packs_epi32(_mm256_srai_epi32(c[0], 16), _mm256_srai_epi32(c[1], 16));
+    const __m256i ra = _mm256_packs_epi32(_mm256_srai_epi32(c[2], 16), _mm256_srai_epi32(c[3], 16));
+    const __m256i p = _mm256_packus_epi16(bg, ra);
+    const __m256i q = _mm256_srli_si256(p, 8);
+    return _mm256_unpacklo_epi16(
+        _mm256_unpacklo_epi8(p, _mm256_srli_si256(p, 4)), _mm256_unpacklo_epi8(q, _mm256_srli_si256(q, 4)));
+  }
+
+  RASTER_TARGET_AVX2 void step() {
+    for (int k = 0; k < 4; k++)
+      c[k] = _mm256_add_epi32(c[k], dc[k]);
+  }
+};
+
+template <bool Fixed, bool Linear>
+RASTER_TARGET_AVX2 static void shaded_row_avx2(const span_t &s)
+{
+    coverage_avx2_t<Fixed> cover(s);
+    colour_avx2_t colour(s);
+    bool inside = false;
+    for (int32_t i = 0; i < s.count; i += 8, cover.step(), colour.step()) {
+        __m256i m = cover.mask();
+        if (i + 8 > s.count)
+            m = _mm256_and_si256(m, tail_mask_avx2(s.count - i));
+        if (_mm256_testz_si256(m, m)) {
+            if (inside)
+                return;
+            continue;
+        }
+        inside = true;
+        const __m256i c = colour.pixels();
+        int *p = (int*)(s.dst + i);
+        _mm256_maskstore_epi32(p, m, blend_avx2<Linear>(_mm256_maskload_epi32(p, m),
+            _mm256_and_si256(c, _mm256_set1_epi32(0xffffff)), _mm256_srli_epi32(c, 24)));
+    }
+}
+
+// Blend the vertex colour times 8 texels (alpha_only: 8 coverage values) over 'dst'
+template <bool Linear, class Sampler>
+RASTER_TARGET_AVX2 static inline __m256i blend_texels_avx2(__m256i dst, __m256i texels, uint32_t colour) {
+    if (Sampler::alpha_only)
+        return blend_avx2<Linear>(dst, _mm256_set1_epi32(int(colour & 0xffffff)), texel_alpha_avx2(texels, colour));
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i c = _mm256_unpacklo_epi8(_mm256_set1_epi32(int(colour)), zero);
+    const __m256i src = _mm256_packus_epi16(
+        div255_avx2(_mm256_mullo_epi16(_mm256_unpacklo_epi8(texels, zero), c)),
+        div255_avx2(_mm256_mullo_epi16(_mm256_unpackhi_epi8(texels, zero), c)));
+    return blend_avx2<Linear>(dst, _mm256_and_si256(src, _mm256_set1_epi32(0xffffff)), _mm256_srli_epi32(src, 24));
+}
+
+// texel_address() of 8 texel indices, wrapping only power of 2 sizes
+template <bool Wrap>
+RASTER_TARGET_AVX2 static inline __m256i texel_index_avx2(__m256i i, int32_t n) {
+    if (Wrap)
+        return _mm256_and_si256(i, _mm256_set1_epi32(n - 1));
+    return _mm256_min_epi32(_mm256_max_epi32(i, _mm256_setzero_si256()), _mm256_set1_epi32(n - 1));
+}
+
+// Texel coordinate as done by floor_int() and texel_address(), 8 at a time
+template <bool Wrap>
+RASTER_TARGET_AVX2 static inline __m256i texel_address_avx2(__m256 f, int32_t n) {
+    f = _mm256_min_ps(_mm256_max_ps(f, _mm256_set1_ps(-1e9f)), _mm256_set1_ps(1e9f));
+    return texel_index_avx2<Wrap>(_mm256_cvttps_epi32(_mm256_floor_ps(f)), n);
+}
+
+// 8 RGBA32 texels at (x, y) as 0xAARRGGBB
+RASTER_TARGET_AVX2 static inline __m256i gather_texels_avx2(const texture_t &tex, __m256i x, __m256i y) {
+    // byte offsets, the addresses are always within the texture
+    const __m256i offset = _mm256_add_epi32(
+        _mm256_mullo_epi32(y, _mm256_set1_epi32(tex.pitch)), _mm256_slli_epi32(x, 2));
+    const __m256i t = _mm256_i32gather_epi32((const int*)tex.tex, offset, 1);
+    // R, G, B, A in memory to 0xAARRGGBB
+    return _mm256_shuffle_epi8(t, _mm256_setr_epi8(
+        2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+        2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15));
+}
+
+// lerp_texel() of 8 texels, 'w' in [0, 256] per 32 bit lane (see lerp_texels_sse2())
+RASTER_TARGET_AVX2 static inline __m256i lerp_texels_avx2(__m256i a, __m256i b, __m256i w) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i w2 = _mm256_or_si256(w, _mm256_slli_epi32(w, 16));
+    const __m256i wlo = _mm256_unpacklo_epi32(w2, w2), whi = _mm256_unpackhi_epi32(w2, w2);
+    const __m256i iwlo = _mm256_sub_epi16(_mm256_set1_epi16(256), wlo), iwhi = _mm256_sub_epi16(_mm256_set1_epi16(256), whi);
+    const __m256i lo = _mm256_add_epi16(
+        _mm256_mullo_epi16(_mm256_unpacklo_epi8(a, zero), iwlo), _mm256_mullo_epi16(_mm256_unpacklo_epi8(b, zero), wlo));
+    const __m256i hi = _mm256_add_epi16(
+        _mm256_mullo_epi16(_mm256_unpackhi_epi8(a, zero), iwhi), _mm256_mullo_epi16(_mm256_unpackhi_epi8(b, zero), whi));
+    return _mm256_packus_epi16(_mm256_srli_epi16(lo, 8), _mm256_srli_epi16(hi, 8));
+}
+
+// Sampler::sample() of a bilinear RGBA32 sampler, 8 at a time: the 4 taps are gathered and
+// blended in 8.8 fixed point. The weights are the fraction of the float coordinates as in
+// sampler_t::taps().
+template <bool Wrap>
+RASTER_TARGET_AVX2 static inline __m256i bilinear_avx2(const texture_t &tex, __m256 u, __m256 v) {
+    const __m256 half = _mm256_set1_ps(.5f), lo = _mm256_set1_ps(-1e9f), hi = _mm256_set1_ps(1e9f);
+    u = _mm256_sub_ps(u, half);
+    v = _mm256_sub_ps(v, half);
+    const __m256 fu = _mm256_floor_ps(_mm256_min_ps(_mm256_max_ps(u, lo), hi));
+    const __m256 fv = _mm256_floor_ps(_mm256_min_ps(_mm256_max_ps(v, lo), hi));
+    const __m256i iu = _mm256_cvttps_epi32(fu), iv = _mm256_cvttps_epi32(fv);
+    const __m256 scale = _mm256_set1_ps(256.f);
+    const __m256i wu = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_sub_ps(u, fu), scale));
+    const __m256i wv = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_sub_ps(v, fv), scale));
+    const __m256i one = _mm256_set1_epi32(1);
+    const int32_t w = int32_t(tex.w), h = int32_t(tex.h);
+    const __m256i x0 = texel_index_avx2<Wrap>(iu, w), x1 = texel_index_avx2<Wrap>(_mm256_add_epi32(iu, one), w);
+    const __m256i y0 = texel_index_avx2<Wrap>(iv, h), y1 = texel_index_avx2<Wrap>(_mm256_add_epi32(iv, one), h);
+    const __m256i top = lerp_texels_avx2(gather_texels_avx2(tex, x0, y0), gather_texels_avx2(tex, x1, y0), wu);
+    const __m256i bottom = lerp_texels_avx2(gather_texels_avx2(tex, x0, y1), gather_texels_avx2(tex, x1, y1), wu);
+    return lerp_texels_avx2(top, bottom, wv);
+}
+
+template <bool Fixed, bool Linear, class Sampler>
+struct textured_avx2_t {
+  // RGBA32 texels can be gathered directly, except when wrapping a non power of 2 size
+  static bool can_gather(const texture_t &tex) {
+      return Sampler::format == TEXTURE_RGBA32 &&
+          (!Sampler::wrap || ((tex.w & (tex.w - 1)) == 0 && (tex.h & (tex.h - 1)) == 0));
+  }
+
+  RASTER_TARGET_AVX2 static void row(const span_t &s, const texture_t &tex, uint32_t colour)
+  {
+      const bool gather = can_gather(tex);
+      coverage_avx2_t<Fixed> cover(s);
+      bool inside = false;
+      for (int32_t i = 0; i < s.count; i += 8, cover.step()) {
+          __m256i m = cover.mask();
+          if (i + 8 > s.count)
+              m = _mm256_and_si256(m, tail_mask_avx2(s.count - i));
+          if (_mm256_testz_si256(m, m)) {
+              if (inside)
+                  return;
+              continue;
+          }
+          inside = true;
+          const __m256 u = _mm256_add_ps(_mm256_set1_ps(s.u), _mm256_mul_ps(_mm256_set1_ps(s.du), cover.x));
+          const __m256 v = _mm256_add_ps(_mm256_set1_ps(s.v), _mm256_mul_ps(_mm256_set1_ps(s.dv), cover.x));
+          __m256i t;
+          if (gather && Sampler::bilinear) {
+              t = bilinear_avx2<Sampler::wrap>(tex, u, v);
+          } else if (gather) {
+              t = gather_texels_avx2(tex,
+                  texel_address_avx2<Sampler::wrap>(u, int32_t(tex.w)), texel_address_avx2<Sampler::wrap>(v, int32_t(tex.h)));
+          } else if (Sampler::bilinear) {
+              // 8 bit texels are fetched by hand (a 32 bit gather could read past the end) and filtered at once
+              alignas(32) float fu[8], fv[8];
+              alignas(32) uint32_t taps[4][8], wu[8], wv[8];
+              _mm256_store_ps(fu, u);
+              _mm256_store_ps(fv, v);
+              uint32_t tk[4];
+              for (int k = 0; k < 8; k++) {
+                  Sampler::taps(tex, fu[k], fv[k], tk, wu[k], wv[k]);
+                  for (int j = 0; j < 4; j++)
+                      taps[j][k] = tk[j];
+              }
+              const __m256i w = _mm256_load_si256((const __m256i*)wu);
+              t = lerp_texels_avx2(
+                  lerp_texels_avx2(_mm256_load_si256((const __m256i*)taps[0]), _mm256_load_si256((const __m256i*)taps[1]), w),
+                  lerp_texels_avx2(_mm256_load_si256((const __m256i*)taps[2]), _mm256_load_si256((const __m256i*)taps[3]), w),
+                  _mm256_load_si256((const __m256i*)wv));
+          } else {
+              // 8 bit texels are sampled by hand, a 32 bit gather could read past the end
+              alignas(32) float fu[8], fv[8];
+              alignas(32) uint32_t ft[8];
+              _mm256_store_ps(fu, u);
+              _mm256_store_ps(fv, v);
+              for (int k = 0; k < 8; k++)
+                  ft[k] = Sampler::sample(tex, fu[k], fv[k]);
+              t = _mm256_load_si256((const __m256i*)ft);
+          }
+          int *p = (int*)(s.dst + i);
+          _mm256_maskstore_epi32(p, m, blend_texels_avx2<Linear, Sampler>(_mm256_maskload_epi32(p, m), t, colour));
+      }
+  }
+};
+
+template <bool Linear>
+RASTER_TARGET_AVX2 static void fill_row_avx2(uint32_t *dst, int32_t count, uint32_t colour)
+{
+    const __m256i c = _mm256_set1_epi32(int(colour & 0xffffff));
+    const __m256i a = _mm256_set1_epi32(int(colour >> 24));
+    const bool opaque = (colour >> 24) == 255;
+    if (const linear_fill_t *fill = (Linear && !opaque) ? linear_fill(colour, count) : NULL) {
+        int32_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256i *p = (__m256i*)(dst + i);
+            _mm256_storeu_si256(p, linear_fill_avx2(*fill, _mm256_loadu_si256(p)));
+        }
+        for (; i < count; i++)
+            dst[i] = fill->blend(dst[i]);
+        return;
+    }
+    int32_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i *p = (__m256i*)(dst + i);
+        _mm256_storeu_si256(p, opaque ? c : blend_avx2<Linear>(_mm256_loadu_si256(p), c, a));
+    }
+    if (i < count) {
+        const __m256i m = tail_mask_avx2(count - i);
+        int *p = (int*)(dst + i);
+        _mm256_maskstore_epi32(p, m, opaque ? c : blend_avx2<Linear>(_mm256_maskload_epi32(p, m), c, a));
+    }
+}
+
+template <bool Linear>
+RASTER_TARGET_AVX2 static void blit_row_avx2(const span_t &s, const uint8_t *texels, int32_t width, uint32_t colour)
+{
+    const __m256i c = _mm256_set1_epi32(int(colour & 0xffffff));
+    const __m256 umax = _mm256_set1_ps(float(width - 1));
+    __m256 x = _mm256_add_ps(_mm256_set1_ps(s.x), _mm256_setr_ps(0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f));
+    for (int32_t i = 0; i < s.count; i += 8) {
+        const __m256 u = _mm256_add_ps(_mm256_set1_ps(s.u), _mm256_mul_ps(_mm256_set1_ps(s.du), x));
+        alignas(32) int32_t iu[8], t[8];
+        _mm256_store_si256((__m256i*)iu, _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(u, _mm256_setzero_ps()), umax)));
+        for (int k = 0; k < 8; k++)
+            t[k] = texels[iu[k]];
+        const __m256i a = texel_alpha_avx2(_mm256_load_si256((const __m256i*)t), colour);
+        const __m256i m = (i + 8 > s.count) ? tail_mask_avx2(s.count - i) : _mm256_set1_epi32(-1);
+        int *p = (int*)(s.dst + i);
+        _mm256_maskstore_epi32(p, m, blend_avx2<Linear>(_mm256_maskload_epi32(p, m), c, a));
+        x = _mm256_add_ps(x, _mm256_set1_ps(8.f));
+    }
+}
+
+// The tail is left to the scalar kernel rather than reading texels past the row
+template <bool Linear>
+RASTER_TARGET_AVX2 static void glyph_row_avx2(uint32_t *dst, const uint8_t *texels, int32_t count, uint32_t colour)
+{
+    const __m256i c = _mm256_set1_epi32(int(colour & 0xffffff));
+    int32_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m128i t = _mm_loadl_epi64((const __m128i*)(texels + i));
+        if (_mm_testz_si128(t, t))
+            continue;
+        const __m256i a = texel_alpha_avx2(_mm256_cvtepu8_epi32(t), colour);
+        __m256i *p = (__m256i*)(dst + i);
+        _mm256_storeu_si256(p, blend_avx2<Linear>(_mm256_loadu_si256(p), c, a));
+    }
+    glyph_row_scalar<Linear>(dst + i, texels + i, count - i, colour);
+}
+
+RASTER_TARGET_AVX2 static void composite_row_avx2(uint32_t *dst, const uint32_t *layer, int32_t count)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i rgb = _mm256_set1_epi32(0xffffff);
+    const __m256i empty = _mm256_set1_epi32(int(0xff000000));
+    int32_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i l = _mm256_loadu_si256((const __m256i*)(layer + i));
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(l, empty)) == -1)
+            continue;
+        __m256i *p = (__m256i*)(dst + i);
+        const __m256i d = _mm256_loadu_si256(p);
+        const __m256i t = _mm256_srli_epi32(l, 24);
+        const __m256i t2 = _mm256_or_si256(t, _mm256_slli_epi32(t, 16));
+        const __m256i lo = div255_avx2(_mm256_mullo_epi16(_mm256_unpacklo_epi32(t2, t2), _mm256_unpacklo_epi8(d, zero)));
+        const __m256i hi = div255_avx2(_mm256_mullo_epi16(_mm256_unpackhi_epi32(t2, t2), _mm256_unpackhi_epi8(d, zero)));
+        const __m256i c = _mm256_adds_epu8(l, _mm256_packus_epi16(lo, hi));
+        _mm256_storeu_si256(p, _mm256_or_si256(_mm256_and_si256(c, rgb), _mm256_andnot_si256(rgb, d)));
+    }
+    composite_row_scalar(dst + i, layer + i, count - i);
+}
+
+static const raster_kernels_t g_kernels_avx2 = {
+  "avx2",
+  { solid_row_avx2<false, false>, solid_row_avx2<true, false> },
+  { textured_dispatch<textured_avx2_t, false, false>, textured_dispatch<textured_avx2_t, true, false> },
+  { shaded_row_avx2<false, false>, shaded_row_avx2<true, false> },
+  fill_row_avx2<false>, blit_row_avx2<false>, glyph_row_avx2<false>, composite_row_avx2
+};
+
+static const raster_kernels_t g_kernels_avx2_linear = {
+  "avx2 linear",
+  { solid_row_avx2<false, true>, solid_row_avx2<true, true> },
+  { textured_dispatch<textured_avx2_t, false, true>, textured_dispatch<textured_avx2_t, true, true> },
+  { shaded_row_avx2<false, true>, shaded_row_avx2<true, true> },
+  fill_row_avx2<true>, blit_row_avx2<true>, glyph_row_avx2<true>, composite_row_avx2
+};
+
+static bool cpu_has_avx2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    // AVX and OSXSAVE, then check the OS saves the YMM state
+    if ((info[2] & (1 << 27 | 1 << 28)) != (1 << 27 | 1 << 28) || (_xgetbv(0) & 6) != 6)
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+#endif // IMGUI_IMPL_RASTER_AVX2
+
+static raster_kernels_t select_kernels(bool linear)
+{
+#if defined(IMGUI_IMPL_RASTER_AVX2)
+    if (cpu_has_avx2())
+        return linear ? g_kernels_avx2_linear : g_kernels_avx2;
+#endif
+#if defined(IMGUI_IMPL_RASTER_SSE2)
+    return linear ? g_kernels_sse2_linear : g_kernels_sse2;
+#else
+    return linear ? g_kernels_scalar_linear : g_kernels_scalar;
+#endif
+}
+
+// Picked once for the process, before any context exists, and shared by all of them
+static const raster_kernels_t g_kernels = select_kernels(false);
+static const raster_kernels_t g_kernels_linear = select_kernels(true);
+
+//-----------------------------------------------------------------------------
+// Target formats
+//-----------------------------------------------------------------------------
+// The kernels draw 0xXXRRGGBB pixels. BGRA32 targets are drawn in place. Rows of other
+// targets are converted into a staging row of the drawing thread, drawn there, and
+// converted back. A staging row is only as wide as the span being drawn, so it stays
+// in the cache and pixels outside of what is drawn are never converted.
+
+// 4x4 ordered dither thresholds (Bayer matrix * 16 + 8), each row twice so that the
+// thresholds of 4 consecutive pixels starting at any x are contiguous
+static const uint16_t g_Dither[4][8] = {
+  {   8, 136,  40, 168,   8, 136,  40, 168 },
+  { 200,  72, 232, 104, 200,  72, 232, 104 },
+  {  56, 184,  24, 152,  56, 184,  24, 152 },
+  { 248, 120, 216,  88, 248, 120, 216,  88 },
+};
+
+// Quantize an 8 bit channel to 'levels' with a dither threshold k:
+// floor(c * levels / 255 + k / 256), x / 255 being (x + (x >> 8)) / 256 for x < 2^16
+static inline uint32_t quantize(uint32_t c, uint32_t levels, uint32_t k) {
+  const uint32_t x = c * levels;
+  return (x + (x >> 8) + k) >> 8;
+}
+
+// Conversion between a target format and the 0xXXRRGGBB staging pixels, one pixel at a
+// time and with SSE2 4 at a time. Both must give the same result.
+template <int Format>
+struct pixel_format_t;
+
+template <>
+struct pixel_format_t<ImGuiImplRasterFormat_RGBA32> {
+  enum { size = 4 };
+  static uint32_t load(const uint8_t *p) {
+    uint32_t c;
+    memcpy(&c, p, 4);
+    return swizzle(c);
+  }
+  static void store(uint8_t *p, uint32_t c, int32_t, int32_t) {
+    c = swizzle(c) | 0xff000000;
+    memcpy(p, &c, 4);
+  }
+#if defined(IMGUI_IMPL_RASTER_SSE2)
+  static __m128i swizzle4(__m128i c) {
+    const __m128i rb = _mm_set1_epi32(0xff);
+    return _mm_or_si128(_mm_and_si128(c, _mm_set1_epi32(int(0xff00ff00))),
+        _mm_or_si128(_mm_and_si128(_mm_srli_epi32(c, 16), rb), _mm_slli_epi32(_mm_and_si128(c, rb), 16)));
+  }
+  static __m128i load4(const uint8_t *p) {
+    return swizzle4(_mm_loadu_si128((const __m128i*)p));
+  }
+  static void store4(uint8_t *p, __m128i c, int32_t, int32_t) {
+    _mm_storeu_si128((__m128i*)p, _mm_or_si128(swizzle4(c), _mm_set1_epi32(int(0xff000000))));
+  }
+#endif
+};
+
+// Dithering is not idempotent, so pixels whose colour did not change are left alone
+template <>
+struct pixel_format_t<ImGuiImplRasterFormat_RGB565> {
+  enum { size = 2 };
+  static uint32_t load(const uint8_t *p) {
+    uint16_t c;
+    memcpy(&c, p, 2);
+    const uint32_t r = c >> 11, g = (c >> 5) & 0x3f, b = c & 0x1f;
+    return ((r << 3 | r >> 2) << 16) | ((g << 2 | g >> 4) << 8) | (b << 3 | b >> 2);
+  }
+  static void store(uint8_t *p, uint32_t c, int32_t x, int32_t y) {
+    if (((load(p) ^ c) & 0xffffff) == 0)
+      return;
+    const uint32_t k = g_Dither[y & 3][x & 3];
+    const uint16_t v = uint16_t(
+        quantize((c >> 16) & 0xff, 31, k) << 11 | quantize((c >> 8) & 0xff, 63, k) << 5 | quantize(c & 0xff, 31, k));
+    memcpy(p, &v, 2);
+  }
+#if defined(IMGUI_IMPL_RASTER_SSE2)
+  static __m128i expand4(__m128i v) {
+    const __m128i c = _mm_unpacklo_epi16(v, _mm_setzero_si128());
+    const __m128i r = _mm_srli_epi32(c, 11);
+    const __m128i g = _mm_and_si128(_mm_srli_epi32(c, 5), _mm_set1_epi32(0x3f));
+    const __m128i b = _mm_and_si128(c, _mm_set1_epi32(0x1f));
+    return _mm_or_si128(_mm_or_si128(
+        _mm_slli_epi32(_mm_or_si128(_mm_slli_epi32(r, 3), _mm_srli_epi32(r, 2)), 16),
+        _mm_slli_epi32(_mm_or_si128(_mm_slli_epi32(g, 2), _mm_srli_epi32(g, 4)), 8)),
+        _mm_or_si128(_mm_slli_epi32(b, 3), _mm_srli_epi32(b, 2)));
+  }
+  static __m128i load4(const uint8_t *p) {
+    return expand4(_mm_loadl_epi64((const __m128i*)p));
+  }
+  // as quantize(), on 16 bit lanes
+  static __m128i quantize4(__m128i c, __m128i levels, __m128i k) {
+    const __m128i x = _mm_mullo_epi16(c, levels);
+    return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), k), 8);
+  }
+  static void store4(uint8_t *p, __m128i c, int32_t x, int32_t y) {
+    const __m128i ff = _mm_set1_epi32(0xff);
+    const __m128i k = _mm_loadl_epi64((const __m128i*)&g_Dither[y & 3][x & 3]);
+    // R0..R3 G0..G3 and B0..B3 in 16 bit lanes
+    const __m128i rg = quantize4(_mm_packs_epi32(
+        _mm_and_si128(_mm_srli_epi32(c, 16), ff), _mm_and_si128(_mm_srli_epi32(c, 8), ff)),
+        _mm_setr_epi16(31, 31, 31, 31, 63, 63, 63, 63), _mm_unpacklo_epi64(k, k));
+    const __m128i b = quantize4(_mm_packs_epi32(_mm_and_si128(c, ff), _mm_setzero_si128()), _mm_set1_epi16(31), k);
+    const __m128i v = _mm_or_si128(_mm_or_si128(_mm_slli_epi16(rg, 11), _mm_srli_si128(_mm_slli_epi16(rg, 5), 8)), b);
+    const __m128i old = _mm_loadl_epi64((const __m128i*)p);
+    const __m128i same = _mm_cmpeq_epi32(expand4(old), _mm_and_si128(c, _mm_set1_epi32(0xffffff)));
+    const __m128i keep = _mm_packs_epi32(same, same);
+    _mm_storel_epi64((__m128i*)p, _mm_or_si128(_mm_and_si128(keep, old), _mm_andnot_si128(keep, v)));
+  }
+#endif
+};
+
+// Vertex colours are white on these targets, so every channel holds the coverage. Images
+// drawn on them still modulate it with their colour, hence the brightest channel.
+template <>
+struct pixel_format_t<ImGuiImplRasterFormat_A8> {
+  enum { size = 1 };
+  static uint32_t load(const uint8_t *p) {
+    return *p * 0x010101u;
+  }
+  static void store(uint8_t *p, uint32_t c, int32_t, int32_t) {
+    *p = uint8_t(std::max(std::max((c >> 16) & 0xff, (c >> 8) & 0xff), c & 0xff));
+  }
+#if defined(IMGUI_IMPL_RASTER_SSE2)
+  static __m128i load4(const uint8_t *p) {
+    int32_t v;
+    memcpy(&v, p, 4);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i a = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(v), zero), zero);
+    return _mm_or_si128(a, _mm_or_si128(_mm_slli_epi32(a, 8), _mm_slli_epi32(a, 16)));
+  }
+  static void store4(uint8_t *p, __m128i c, int32_t, int32_t) {
+    const __m128i m = _mm_and_si128(_mm_max_epu8(_mm_max_epu8(c, _mm_srli_epi32(c, 8)), _mm_srli_epi32(c, 16)), _mm_set1_epi32(0xff));
+    const __m128i w = _mm_packs_epi32(m, m);
+    const int32_t v = _mm_cvtsi128_si32(_mm_packus_epi16(w, w));
+    memcpy(p, &v, 4);
+  }
+#endif
+};
+
+template <int Format>
+static void load_row(const uint8_t *src, int32_t count, uint32_t *out)
+{
+    typedef pixel_format_t<Format> format;
+    int32_t i = 0;
+#if defined(IMGUI_IMPL_RASTER_SSE2)
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_si128((__m128i*)(out + i), format::load4(src + i * format::size));
+#endif
+    for (; i < count; i++)
+        out[i] = format::load(src + i * format::size);
+}
+
+template <int Format>
+static void store_row(uint8_t *dst, int32_t x, int32_t y, int32_t count, const uint32_t *in)
+{
+    typedef pixel_format_t<Format> format;
+    int32_t i = 0;
+#if defined(IMGUI_IMPL_RASTER_SSE2)
+    for (; i + 4 <= count; i += 4)
+        format::store4(dst + i * format::size, _mm_loadu_si128((const __m128i*)(in + i)), x + i, y);
+#endif
+    for (; i < count; i++)
+        format::store(dst + i * format::size, in[i], x + i, y);
+}
+
+// Staging row of the calling thread
+static thread_local std::vector<uint32_t> g_Staging;
+
+// Pixels [x, x + count) of row 'y' for a kernel to draw into, then call target_row_done()
+static inline uint32_t *target_row(const raster_target_t &rt, int32_t x, int32_t y, int32_t count)
+{
+    uint8_t *p = rt.pixels + size_t(y - rt.y0) * rt.pitch + size_t(x - rt.x0) * rt.bpp;
+    if (!rt.load)
+        return (uint32_t*)p;
+    std::vector<uint32_t> &staging = g_Staging;
+    if (staging.size() < size_t(count))
+        staging.resize(count);
+    rt.load(p, count, staging.data());
+    return staging.data();
+}
+
+static inline void target_row_done(const raster_target_t &rt, int32_t x, int32_t y, int32_t count)
+{
+    if (rt.store)
+        rt.store(rt.pixels + size_t(y - rt.y0) * rt.pitch + size_t(x - rt.x0) * rt.bpp, x, y, count, g_Staging.data());
+}
+
+static inline void span_done(const raster_target_t &rt, const span_t &s)
+{
+    target_row_done(rt, s.px, s.py, s.count);
+}
+
+// Set up the parts of 'rt' that depend on the pixel format
+static void target_format(raster_target_t &rt, ImGuiImplRasterFormat format)
+{
+    rt.load = NULL;
+    rt.store = NULL;
+    rt.white = 0;
+    rt.kernels = &g_kernels;
+    switch (format) {
+    case ImGuiImplRasterFormat_RGBA32:
+        rt.bpp = 4;
+        rt.load = load_row<ImGuiImplRasterFormat_RGBA32>;
+        rt.store = store_row<ImGuiImplRasterFormat_RGBA32>;
+        break;
+    case ImGuiImplRasterFormat_RGB565:
+        rt.bpp = 2;
+        rt.load = load_row<ImGuiImplRasterFormat_RGB565>;
+        rt.store = store_row<ImGuiImplRasterFormat_RGB565>;
+        break;
+    case ImGuiImplRasterFormat_A8:
+        rt.bpp = 1;
+        rt.load = load_row<ImGuiImplRasterFormat_A8>;
+        rt.store = store_row<ImGuiImplRasterFormat_A8>;
+        rt.white = 0xffffff;
+        break;
+    default:
+        rt.bpp = 4;
+        break;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Triangles
+//-----------------------------------------------------------------------------
+
+// Count a row of a triangle for ImGuiImplRasterFlags_Stats. The covered pixels are exact
+// with the fixed point core, the float one counts the range solve_row() gives.
+static void count_row(const raster_target_t &rt, const triangle_t &t, int32_t py, int32_t x0, int32_t x1)
+{
+    raster_count_t &c = rt.counts[rt.list];
+    c.tested += uint64_t(x1 - x0);
+    if (!t.walk || !t.fixed)
+        solve_row(t, py, x0, x1);
+    c.written += uint64_t(std::max(x1 - x0, 0));
+}
+
+// Set up the row 'py' of a triangle in 's', returns false if nothing is covered.
+// Walked fixed point triangles get the exact covered range and always covered edges.
+static inline bool triangle_row(const raster_target_t &rt, const triangle_t &t, int32_t py, span_t &s)
+{
+    int32_t x0 = t.bounds.x0, x1 = t.bounds.x1;
+    if (t.walk)
+        solve_row(t, py, x0, x1);
+    if (x0 >= x1)
+        return false;
+    if (rt.counts)
+        count_row(rt, t, py, x0, x1);
+    const float y = float(py - t.oy);
+    s.dst = target_row(rt, x0, py, x1 - x0);
+    s.count = x1 - x0;
+    s.px = x0;
+    s.py = py;
+    s.x = float(x0 - t.ox);
+    s.w[0] = t.e0.row(y); s.w[1] = t.e1.row(y); s.w[2] = t.e2.row(y);
+    s.dw[0] = t.e0.a; s.dw[1] = t.e1.a; s.dw[2] = t.e2.a;
+    if (t.fixed && !t.walk) {
+        const fixed_edge_t *edges[3] = { &t.f0, &t.f1, &t.f2 };
+        for (int k = 0; k < 3; k++) {
+            s.e[k] = int32_t(edges[k]->a * (x0 - t.ox) + edges[k]->b * (py - t.oy) + edges[k]->c);
+            s.de[k] = int32_t(edges[k]->a);
+        }
+    } else {
+        s.e[0] = s.e[1] = s.e[2] = 0;
+        s.de[0] = s.de[1] = s.de[2] = 0;
+    }
+    return true;
+}
+
+// Plane of one 8 bit channel of the vertex colours in 16.16 fixed point, rounded. It is
+// evaluated exactly in integers, the constant term is kept in 64 bits as it may be far
+// out of range at the origin of a thin triangle.
+struct colour_plane_t {
+  int32_t a, b;
+  int64_t c;
+};
+
+static inline colour_plane_t colour_plane(const triangle_t &t, uint32_t c0, uint32_t c1, uint32_t c2, int shift)
+{
+    const plane_t p = attribute_plane(t,
+        float((c0 >> shift) & 0xff), float((c1 >> shift) & 0xff), float((c2 >> shift) & 0xff));
+    const float limit = 2e9f;
+    return colour_plane_t{
+        int32_t(lrintf(std::min(std::max(p.a * 65536.f, -limit), limit))),
+        int32_t(lrintf(std::min(std::max(p.b * 65536.f, -limit), limit))),
+        int64_t(llrint(double(p.c) * 65536.0)) + 0x8000 };
+}
+
+static bool draw_triangle(
+    const raster_target_t &rt,
+    const vec2f_t& v0,
+    const vec2f_t& v1,
+    const vec2f_t& v2,
+    uint32_t c0,
+    uint32_t c1,
+    uint32_t c2,
+    const rect_t &clip)
+{
+    triangle_t t;
+    if (((c0 | c1 | c2) >> 24) == 0 || !setup_triangle(t, rt.fixed, v0, v1, v2, clip))
+        return false;
+    span_t s;
+    // flat triangles (nearly all of them) keep the single colour kernel
+    if (c0 == c1 && c1 == c2) {
+        const auto kernel = rt.kernels->solid[t.fixed];
+        for (int32_t py = t.bounds.y0; py < t.bounds.y1; py++) {
+            if (!triangle_row(rt, t, py, s))
+                continue;
+            kernel(s, c0);
+            span_done(rt, s);
+        }
+        return true;
+    }
+    colour_plane_t planes[4];
+    for (int k = 0; k < 4; k++) {
+        planes[k] = colour_plane(t, c0, c1, c2, k * 8);
+        s.dcol[k] = planes[k].a;
+    }
+    const auto kernel = rt.kernels->shaded[t.fixed];
+    for (int32_t py = t.bounds.y0; py < t.bounds.y1; py++) {
+        if (!triangle_row(rt, t, py, s))
+            continue;
+        const int64_t x = int64_t(s.x), y = py - t.oy;
+        for (int k = 0; k < 4; k++)
+            s.col[k] = int32_t(uint32_t(planes[k].a * x + planes[k].b * y + planes[k].c));
+        kernel(s);
+        span_done(rt, s);
+    }
+    return true;
+}
+
+static bool draw_triangle(
+    const raster_target_t &rt,
+    const vec2f_t& v0,
+    const vec2f_t& v1,
+    const vec2f_t& v2,
+    const vec2f_t& t0,
+    const vec2f_t& t1,
+    const vec2f_t& t2,
+    const texture_t & tex,
+    uint32_t colour,
+    const rect_t &clip)
+{
+    triangle_t tri;
+    if ((colour >> 24) == 0 || !setup_triangle(tri, rt.fixed, v0, v1, v2, clip))
+        return false;
+    // texture coordinate planes
+    const plane_t tu = attribute_plane(tri, t0.x, t1.x, t2.x);
+    const plane_t tv = attribute_plane(tri, t0.y, t1.y, t2.y);
+    texture_t filtered;
+    const texture_t &ft = filter_texture(tex, tu.a, tu.b, tv.a, tv.b, filtered);
+    const auto kernel = rt.kernels->textured[tri.fixed];
+    span_t s;
+    s.du = tu.a;
+    s.dv = tv.a;
+    // rendering loop
+    for (int32_t py = tri.bounds.y0; py < tri.bounds.y1; py++) {
+        if (!triangle_row(rt, tri, py, s))
+            continue;
+        const float y = float(py - tri.oy);
+        s.u = tu.row(y);
+        s.v = tv.row(y);
+        kernel(s, ft, colour);
+        span_done(rt, s);
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Rectangles
+//-----------------------------------------------------------------------------
+// Most of the geometry (window backgrounds, frames, glyphs) comes from PrimRect(),
+// PrimRectUV() and RenderText() as two triangles (a, b, c) (a, c, d) over an axis
+// aligned quad. Those are drawn as a whole with row spans and no edge functions.
+// A pixel is covered when its centre is inside the rectangle, which is the union of
+// what the two triangles would cover: with the fixed point core the corners are snapped
+// and the right and bottom edges are excluded (top-left rule), with the float core all
+// edges are included.
+
+// True if the six indices at 'idx' form such a rectangle, with a single colour and
+// texture coordinates aligned with it
+static bool is_rect(const ImDrawVert *vert, const ImDrawIdx *idx)
+{
+    if (idx[3] != idx[0] || idx[4] != idx[2])
+        return false;
+    const ImDrawVert & a = vert[idx[0]];
+    const ImDrawVert & b = vert[idx[1]];
+    const ImDrawVert & c = vert[idx[2]];
+    const ImDrawVert & d = vert[idx[5]];
+    if (a.pos.y != b.pos.y || b.pos.x != c.pos.x || c.pos.y != d.pos.y || d.pos.x != a.pos.x)
+        return false;
+    if (a.col != b.col || a.col != c.col || a.col != d.col)
+        return false;
+    return a.uv.y == b.uv.y && b.uv.x == c.uv.x && c.uv.y == d.uv.y && d.uv.x == a.uv.x;
+}
+
+// Number of indices of the primitive starting at 'idx'
+static inline uint32_t prim_size(const ImDrawVert *vert, const ImDrawIdx *idx, uint32_t remaining)
+{
+    return (remaining >= 6 && is_rect(vert, idx)) ? 6 : 3;
+}
+
+// Top left corner 'p0' (snapped with the fixed point core) and the pixels of the rectangle
+// with corners 'a' and 'c', returns false if it has no area
+static bool rect_pixels(bool fixed, const ImDrawVert &a, const ImDrawVert &c, vec2f_t &p0, rect_t &full)
+{
+    p0 = vec2f_t{std::min(a.pos.x, c.pos.x), std::min(a.pos.y, c.pos.y)};
+    vec2f_t p1 = vec2f_t{std::max(a.pos.x, c.pos.x), std::max(a.pos.y, c.pos.y)};
+    if (fixed) {
+        p0 = snap(p0);
+        p1 = snap(p1);
+    }
+    if (p0.x == p1.x || p0.y == p1.y)
+        return false;
+    // pixels whose centre lies in [x0, x1) x [y0, y1), or [x0, x1] x [y0, y1]
+    full = fixed ?
+        rect_t{ int32_t(ceilf(p0.x - .5f)), int32_t(ceilf(p0.y - .5f)),
+                int32_t(ceilf(p1.x - .5f)), int32_t(ceilf(p1.y - .5f)) } :
+        rect_t{ int32_t(ceilf(p0.x - .5f)), int32_t(ceilf(p0.y - .5f)),
+                int32_t(floorf(p1.x - .5f)) + 1, int32_t(floorf(p1.y - .5f)) + 1 };
+    return true;
+}
+
+static bool draw_rect(const raster_target_t &rt, const ImDrawVert &a, const ImDrawVert &c, const texture_t &tex, const rect_t &clip)
+{
+    const uint32_t colour = swizzle(a.col) | rt.white;
+    vec2f_t p0;
+    rect_t full;
+    if ((colour >> 24) == 0 || !rect_pixels(rt.fixed, a, c, p0, full))
+        return false;
+    const float x0 = p0.x, y0 = p0.y;
+    const rect_t r = intersect(clip, full);
+    if (r.empty())
+        return false;
+    const int32_t count = r.x1 - r.x0;
+    if (rt.counts) {
+        raster_count_t &counts = rt.counts[rt.list];
+        const uint64_t pixels = uint64_t(count) * uint64_t(r.y1 - r.y0);
+        counts.tested += pixels;
+        counts.written += pixels;
+    }
+
+    // the font atlas white pixel
+    if (a.uv == c.uv && &tex == rt.font) {
+        for (int32_t y = r.y0; y < r.y1; y++) {
+            rt.kernels->fill(target_row(rt, r.x0, y, count), count, colour);
+            target_row_done(rt, r.x0, y, count);
+        }
+        return true;
+    }
+
+    // texture coordinates relative to the rectangle origin, u varies along x only and v along y
+    const int32_t ox = int32_t(floorf(x0)), oy = int32_t(floorf(y0));
+    const float du = (c.uv.x - a.uv.x) * tex.w / (c.pos.x - a.pos.x);
+    const float dv = (c.uv.y - a.uv.y) * tex.h / (c.pos.y - a.pos.y);
+    span_t s = {};
+    s.count = count;
+    s.x = float(r.x0 - ox);
+    s.du = du;
+    s.u = a.uv.x * tex.w + du * (float(ox) + .5f - a.pos.x);
+    const float v0 = a.uv.y * tex.h + dv * (float(oy) + .5f - a.pos.y);
+
+    texture_t filtered;
+    const texture_t &ft = filter_texture(tex, du, 0.f, 0.f, dv, filtered);
+
+    // 8 bit nearest/clamp textures (the font atlas at 1:1) are blitted a row at a time, anything
+    // else goes through the textured kernels with every pixel covered
+    if (ft.sampler != texture_sampler(TEXTURE_A8, false, false)) {
+        const auto kernel = rt.kernels->textured[1];
+        s.dv = 0.f;
+        for (int32_t y = r.y0; y < r.y1; y++) {
+            s.dst = target_row(rt, r.x0, y, count);
+            s.v = v0 + dv * float(y - oy);
+            kernel(s, ft, colour);
+            target_row_done(rt, r.x0, y, count);
+        }
+        return true;
+    }
+
+    // Glyphs at their rasterized size map one texel to one pixel: copy texel rows. The
+    // texels are counted from the first pixel of the whole rectangle, so tiles agree.
+    if (fabsf(du - 1.f) < 1e-3f && fabsf(dv - 1.f) < 1e-3f) {
+        const int32_t tx = int32_t(floorf(s.u + du * float(full.x0 - ox))) - full.x0;
+        const int32_t ty = int32_t(floorf(v0 + dv * float(full.y0 - oy))) - full.y0;
+        if (tx + r.x0 >= 0 && tx + r.x1 <= int32_t(ft.w) && ty + r.y0 >= 0 && ty + r.y1 <= int32_t(ft.h)) {
+            for (int32_t y = r.y0; y < r.y1; y++) {
+                rt.kernels->glyph(target_row(rt, r.x0, y, count), ft.tex + (ty + y) * ft.pitch + tx + r.x0, count, colour);
+                target_row_done(rt, r.x0, y, count);
+            }
+            return true;
+        }
+    }
+    const float vmax = float(ft.h - 1);
+    for (int32_t y = r.y0; y < r.y1; y++) {
+        const float v = std::min(std::max(v0 + dv * float(y - oy), 0.f), vmax);
+        s.dst = target_row(rt, r.x0, y, count);
+        rt.kernels->blit(s, ft.tex + int32_t(v) * ft.pitch, int32_t(ft.w), colour);
+        target_row_done(rt, r.x0, y, count);
+    }
+    return true;
+}
+
+// Rasterize one primitive (3 or 6 indices) of a draw command, restricted to 'clip'.
+// Returns false if it was dropped before rasterization (transparent, degenerate or clipped).
+static bool draw_prim(const raster_target_t &rt, const ImDrawVert *vert, const ImDrawIdx *idx, uint32_t size, const texture_t &tex, const rect_t &clip)
+{
+    if (size == 6)
+        return draw_rect(rt, vert[idx[0]], vert[idx[2]], tex, clip);
+    const ImDrawVert & v0 = vert[idx[0]];
+    const ImDrawVert & v1 = vert[idx[1]];
+    const ImDrawVert & v2 = vert[idx[2]];
+
+    // untextured geometry samples the font atlas white pixel
+    if (v0.uv == v1.uv && &tex == rt.font) {
+      return draw_triangle(
+        rt,
+        vec2f_t{v0.pos.x, v0.pos.y},
+        vec2f_t{v1.pos.x, v1.pos.y},
+        vec2f_t{v2.pos.x, v2.pos.y},
+        swizzle(v0.col) | rt.white,
+        swizzle(v1.col) | rt.white,
+        swizzle(v2.col) | rt.white,
+        clip);
+    } else {
+      return draw_triangle(
+        rt,
+        vec2f_t{v0.pos.x, v0.pos.y},
+        vec2f_t{v1.pos.x, v1.pos.y},
+        vec2f_t{v2.pos.x, v2.pos.y},
+        vec2f_t{v0.uv.x * tex.w, v0.uv.y * tex.h},
+        vec2f_t{v1.uv.x * tex.w, v1.uv.y * tex.h},
+        vec2f_t{v2.uv.x * tex.w, v2.uv.y * tex.h},
+        tex,
+        swizzle(v0.col) | rt.white,
+        clip);
+    }
+}
+
+// Whether draw_prim() would rasterize the primitive, without drawing it. In tiled mode
+// primitives are drawn once per tile, statistics count them once with this when binning.
+static bool prim_visible(const raster_target_t &rt, const ImDrawVert *vert, const ImDrawIdx *idx, uint32_t size, const texture_t &tex, const rect_t &clip)
+{
+    const ImDrawVert & v0 = vert[idx[0]];
+    const ImDrawVert & v1 = vert[idx[1]];
+    const ImDrawVert & v2 = vert[idx[2]];
+    if (size == 6) {
+        vec2f_t p0;
+        rect_t full;
+        return ((swizzle(v0.col) | rt.white) >> 24) != 0 && rect_pixels(rt.fixed, v0, v2, p0, full) && !intersect(clip, full).empty();
+    }
+    const uint32_t alpha = (v0.uv == v1.uv && &tex == rt.font) ?
+        (swizzle(v0.col) | swizzle(v1.col) | swizzle(v2.col) | rt.white) >> 24 :
+        (swizzle(v0.col) | rt.white) >> 24;
+    triangle_t t;
+    return alpha != 0 && setup_triangle(t, rt.fixed,
+        vec2f_t{v0.pos.x, v0.pos.y}, vec2f_t{v1.pos.x, v1.pos.y}, vec2f_t{v2.pos.x, v2.pos.y}, clip);
+}
+
+//-----------------------------------------------------------------------------
+// Textures
+//-----------------------------------------------------------------------------
+// Each context has its own texture slots. ImTextureID is the index of a slot plus one,
+// so NULL is never valid. Slot 0 holds the font atlas, so its ImTextureID is the same in
+// every context and a font atlas may be shared. Texels are referenced, not copied.
+
+static texture_t *find_texture(std::vector<texture_t> &textures, ImTextureID id)
+{
+    const intptr_t slot = intptr_t(id) - 1;
+    if (slot < 0 || slot >= intptr_t(textures.size()) || !textures[slot].tex)
+        return NULL;
+    return &textures[slot];
+}
+
+static void set_texture(texture_t &tex, const void *pixels, int width, int height, int pitch, texture_format_e format, ImGuiImplRasterTextureFlags flags)
+{
+    tex.w = uint32_t(width);
+    tex.h = uint32_t(height);
+    tex.tex = (const uint8_t*)pixels;
+    tex.pitch = pitch ? pitch : width * (format == TEXTURE_RGBA32 ? 4 : 1);
+    tex.sampler = texture_sampler(format,
+        (flags & ImGuiImplRasterTextureFlags_Bilinear) != 0, (flags & ImGuiImplRasterTextureFlags_Wrap) != 0);
+    tex.auto_filter = (flags & ImGuiImplRasterTextureFlags_AutoFilter) != 0;
+    // a reused slot keeps counting so the dirty rectangles see the change
+    tex.version++;
+}
+
+//-----------------------------------------------------------------------------
+// Dirty rectangles
+//-----------------------------------------------------------------------------
+// With ImGuiImplRasterFlags_DirtyRects each draw list is hashed (vertices, indices
+// and commands) together with its screen bounds. A list whose hash or bounds differ
+// from the list at the same position last frame dirties both its old and new bounds,
+// lists that appeared or went away dirty their bounds too. The dirty regions are then
+// cleared and everything is redrawn clipped to them. Anything we cannot track (user
+// callbacks, a new atlas, a different projection) redraws the whole target. Changes to
+// other textures are seen through their version, see ImGui_ImplRaster_UpdateTexture().
+
+static const int MAX_DIRTY_RECTS = 16;
+
+struct raster_list_state_t {
+  uint64_t hash;
+  rect_t bounds;
+};
+
+// What the whole frame depends on besides the draw lists
+struct raster_frame_state_t {
+  ImVec2 clip_off, clip_scale;
+  const uint8_t *font;
+  uint32_t font_w, font_h;
+};
+
+// Dirty rectangle state of one context
+struct raster_dirty_t {
+  std::vector<raster_list_state_t> lists, lists_prev;
+  std::vector<rect_t> rects;
+  std::vector<ImGuiImplRasterRect> out;   // as returned by ImGui_ImplRaster_GetDirtyRects()
+  raster_frame_state_t frame_prev = {};
+  bool invalidated = true;
+};
+
+static inline uint64_t hash_mix(uint64_t h, uint64_t v) {
+  h ^= v;
+  h *= 0x100000001b3ull;
+  return h ^ (h >> 29);
+}
+
+static uint64_t hash_bytes(uint64_t h, const void *data, size_t size)
+{
+    const uint8_t *p = (const uint8_t*)data;
+    for (; size >= 8; size -= 8, p += 8) {
+        uint64_t v;
+        memcpy(&v, p, 8);
+        h = hash_mix(h, v);
+    }
+    uint64_t v = 0;
+    memcpy(&v, p, size);
+    return hash_mix(h, v ^ (uint64_t(size) << 56));
+}
+
+static inline uint64_t hash_float(uint64_t h, float f) {
+  uint32_t v;
+  memcpy(&v, &f, 4);
+  return hash_mix(h, v);
+}
+
+// Hash a draw list and find the pixels it can touch, returns false if it has user callbacks
+static bool hash_list(
+    const ImDrawList *list,
+    std::vector<texture_t> &textures,
+    const rect_t &viewport,
+    const ImVec2 &clip_off,
+    const ImVec2 &clip_scale,
+    raster_list_state_t &out)
+{
+    uint64_t h = 0xcbf29ce484222325ull;
+    h = hash_bytes(h, list->VtxBuffer.Data, list->VtxBuffer.Size * sizeof(ImDrawVert));
+    h = hash_bytes(h, list->IdxBuffer.Data, list->IdxBuffer.Size * sizeof(ImDrawIdx));
+    rect_t clip = {0, 0, 0, 0};
+    // field by field, ImDrawCmd has padding
+    for (const ImDrawCmd &cmd : list->CmdBuffer) {
+        if (cmd.UserCallback != NULL && cmd.UserCallback != ImDrawCallback_ResetRenderState)
+            return false;
+        h = hash_float(h, cmd.ClipRect.x); h = hash_float(h, cmd.ClipRect.y);
+        h = hash_float(h, cmd.ClipRect.z); h = hash_float(h, cmd.ClipRect.w);
+        h = hash_mix(h, uint64_t(intptr_t(cmd.TextureId)));
+        const texture_t *tex = find_texture(textures, cmd.TextureId);
+        h = hash_mix(h, tex ? tex->version : 0);
+        h = hash_mix(h, (uint64_t(cmd.VtxOffset) << 32) | cmd.IdxOffset);
+        h = hash_mix(h, uint64_t(cmd.ElemCount));
+        if (cmd.ElemCount)
+            clip = bounding(clip, project_rect(cmd.ClipRect, clip_off, clip_scale));
+    }
+    float x0 = FLT_MAX, y0 = FLT_MAX, x1 = -FLT_MAX, y1 = -FLT_MAX;
+    for (const ImDrawVert &v : list->VtxBuffer) {
+        x0 = std::min(x0, v.pos.x); x1 = std::max(x1, v.pos.x);
+        y0 = std::min(y0, v.pos.y); y1 = std::max(y1, v.pos.y);
+    }
+    out.hash = h;
+    out.bounds = rect_t{0, 0, 0, 0};
+    if (x0 <= x1) {
+        const rect_t verts = {
+            int32_t(floorf((x0 - clip_off.x) * clip_scale.x)), int32_t(floorf((y0 - clip_off.y) * clip_scale.y)),
+            int32_t(ceilf((x1 - clip_off.x) * clip_scale.x)) + 1, int32_t(ceilf((y1 - clip_off.y) * clip_scale.y)) + 1 };
+        out.bounds = intersect(intersect(verts, clip), viewport);
+    }
+    return true;
+}
+
+static void add_dirty(raster_dirty_t &dirty, const rect_t &r)
+{
+    if (!r.empty())
+        dirty.rects.push_back(r);
+}
+
+// Merge overlapping regions, so no pixel is drawn twice, and cap their number
+static void merge_dirty(std::vector<rect_t> &rects)
+{
+    for (bool merged = true; merged; ) {
+        merged = false;
+        for (size_t i = 0; i < rects.size(); i++) {
+            for (size_t j = i + 1; j < rects.size(); ) {
+                if (intersect(rects[i], rects[j]).empty()) {
+                    j++;
+                    continue;
+                }
+                rects[i] = bounding(rects[i], rects[j]);
+                rects.erase(rects.begin() + j);
+                merged = true;
+            }
+        }
+    }
+    if (rects.size() > MAX_DIRTY_RECTS) {
+        for (size_t i = 1; i < rects.size(); i++)
+            rects[0] = bounding(rects[0], rects[i]);
+        rects.resize(1);
+    }
+}
+
+static void compute_dirty(
+    raster_dirty_t &dirty,
+    std::vector<texture_t> &textures,
+    const rect_t &viewport,
+    ImDrawData* draw_data,
+    const ImVec2 &clip_off,
+    const ImVec2 &clip_scale)
+{
+    dirty.rects.clear();
+    const texture_t &font = textures[0];
+    const raster_frame_state_t frame = {clip_off, clip_scale, font.tex, font.w, font.h};
+    const raster_frame_state_t &prev = dirty.frame_prev;
+    bool full = dirty.invalidated ||
+        memcmp(&frame.clip_off, &prev.clip_off, sizeof(ImVec2) * 2) != 0 ||
+        frame.font != prev.font || frame.font_w != prev.font_w || frame.font_h != prev.font_h;
+    dirty.frame_prev = frame;
+    dirty.invalidated = false;
+
+    std::vector<raster_list_state_t> &lists = dirty.lists, &lists_prev = dirty.lists_prev;
+    lists.resize(draw_data->CmdListsCount);
+    for (int n = 0; n < draw_data->CmdListsCount; n++) {
+        if (!hash_list(draw_data->CmdLists[n], textures, viewport, clip_off, clip_scale, lists[n]))
+            full = true;
+    }
+    if (!full) {
+        const size_t count = std::max(lists.size(), lists_prev.size());
+        for (size_t n = 0; n < count; n++) {
+            const raster_list_state_t *cur = n < lists.size() ? &lists[n] : NULL;
+            const raster_list_state_t *prev_list = n < lists_prev.size() ? &lists_prev[n] : NULL;
+            if (cur && prev_list && cur->hash == prev_list->hash && memcmp(&cur->bounds, &prev_list->bounds, sizeof(rect_t)) == 0)
+                continue;
+            if (cur)       add_dirty(dirty, cur->bounds);
+            if (prev_list) add_dirty(dirty, prev_list->bounds);
+        }
+        merge_dirty(dirty.rects);
+    } else {
+        dirty.rects.push_back(viewport);
+    }
+    lists.swap(lists_prev);
+}
+
+//-----------------------------------------------------------------------------
+// Occlusion culling
+//-----------------------------------------------------------------------------
+// With ImGuiImplRasterFlags_OcclusionCulling a pre-pass over the frame finds the
+// opaque untextured rectangles (window backgrounds with an opaque WindowBg, frames)
+// and records, for each screen tile, the last one that covers the whole tile. Any
+// primitive drawn before it in that tile is overwritten, so it is skipped there.
+// Primitives are ordered by a key: the draw list index in the high 32 bits and the
+// offset of their first index in that list in the low 32 bits.
+
+static const int32_t TILE_SIZE = 64;    // of the occlusion grid and the tiled renderer
+
+// Occluders of one frame
+struct raster_occlusion_t {
+  int32_t tiles_x = 0, tiles_y = 0;
+  std::vector<uint64_t> keys;       // per tile, everything with a smaller key is hidden (empty: no culling)
+};
+
+// A rectangle that replaces every pixel it covers, whatever was there
+static bool is_occluder(const ImDrawVert *vert, const ImDrawIdx *idx, const texture_t &tex, const raster_target_t &rt)
+{
+    const ImDrawVert & a = vert[idx[0]];
+    const ImDrawVert & c = vert[idx[2]];
+    return &tex == rt.font && a.uv == c.uv && ((a.col >> IM_COL32_A_SHIFT) & 0xff) == 0xff;
+}
+
+static void compute_occlusion(
+    raster_occlusion_t &occ,
+    const raster_target_t &rt,
+    std::vector<texture_t> &textures,
+    const rect_t &viewport,
+    ImDrawData *draw_data)
+{
+    occ.tiles_x = (viewport.x1 + TILE_SIZE - 1) / TILE_SIZE;
+    occ.tiles_y = (viewport.y1 + TILE_SIZE - 1) / TILE_SIZE;
+    occ.keys.assign(occ.tiles_x * occ.tiles_y, 0);
+    const ImVec2 clip_off = draw_data->DisplayPos;
+    const ImVec2 clip_scale = draw_data->FramebufferScale;
+    for (int n = 0; n < draw_data->CmdListsCount; n++) {
+        const ImDrawList *list = draw_data->CmdLists[n];
+        const ImDrawIdx *idx = list->IdxBuffer.Data;
+        uint32_t offset = 0;
+        for (const ImDrawCmd &cmd : list->CmdBuffer) {
+            const ImDrawVert *vert = list->VtxBuffer.Data + cmd.VtxOffset;
+            const texture_t *tex = find_texture(textures, cmd.TextureId);
+            const rect_t clip = intersect(project_rect(cmd.ClipRect, clip_off, clip_scale), viewport);
+            if (!cmd.UserCallback && tex == rt.font && !clip.empty()) {
+                for (uint32_t i = 0, size; i < cmd.ElemCount; i += size) {
+                    size = prim_size(vert, idx + offset + i, cmd.ElemCount - i);
+                    vec2f_t p0;
+                    rect_t full;
+                    if (size != 6 || !is_occluder(vert, idx + offset + i, *tex, rt) ||
+                        !rect_pixels(rt.fixed, vert[idx[offset + i]], vert[idx[offset + i + 2]], p0, full))
+                        continue;
+                    // the tiles (cut by the viewport) completely inside
+                    const rect_t r = intersect(clip, full);
+                    const int32_t tx0 = (r.x0 + TILE_SIZE - 1) / TILE_SIZE;
+                    const int32_t ty0 = (r.y0 + TILE_SIZE - 1) / TILE_SIZE;
+                    const int32_t tx1 = r.x1 >= viewport.x1 ? occ.tiles_x : r.x1 / TILE_SIZE;
+                    const int32_t ty1 = r.y1 >= viewport.y1 ? occ.tiles_y : r.y1 / TILE_SIZE;
+                    const uint64_t key = (uint64_t(n) << 32) | (offset + i);
+                    for (int32_t ty = ty0; ty < ty1; ty++)
+                        for (int32_t tx = tx0; tx < tx1; tx++)
+                            occ.keys[ty * occ.tiles_x + tx] = key;
+                }
+            }
+            offset += cmd.ElemCount;
+        }
+    }
+}
+
+// Shrink 'bounds' to the tiles where the primitive 'key' is not hidden, returns false if
+// it is hidden everywhere
+static bool occlusion_visible(const raster_occlusion_t &occ, uint64_t key, rect_t &bounds)
+{
+    if (occ.keys.empty() || bounds.empty())
+        return !bounds.empty();
+    const int32_t tx0 = bounds.x0 / TILE_SIZE, tx1 = (bounds.x1 - 1) / TILE_SIZE;
+    const int32_t ty0 = bounds.y0 / TILE_SIZE, ty1 = (bounds.y1 - 1) / TILE_SIZE;
+    rect_t visible = {0, 0, 0, 0};
+    for (int32_t ty = ty0; ty <= ty1; ty++) {
+        for (int32_t tx = tx0; tx <= tx1; tx++) {
+            if (occ.keys[ty * occ.tiles_x + tx] <= key)
+                visible = bounding(visible, rect_t{tx * TILE_SIZE, ty * TILE_SIZE, (tx + 1) * TILE_SIZE, (ty + 1) * TILE_SIZE});
+        }
+    }
+    bounds = intersect(bounds, visible);
+    return !bounds.empty();
+}
+
+//-----------------------------------------------------------------------------
+// Layer cache
+//-----------------------------------------------------------------------------
+// With ImGuiImplRasterFlags_LayerCache a draw list that did not change since the
+// previous frame (same hash as in the dirty rectangles, same bounds) is rasterized
+// once into a layer and composited from then on. The list is drawn over black and
+// over white: blending is affine in the destination, so out = black + t * dst / 255
+// with the transmittance t = white - black, up to the rounding of the individual
+// blends (a step or so from drawing the list directly). A layer keeps the black
+// colour and t (of the green channel, they only differ by rounding) in the unused
+// byte. Lists with user callbacks are always drawn. Layers least recently used are
+// dropped to stay in the budget. Lists that mostly fill their bounds once (a modal
+// dimming the screen) are cheaper to draw than to composite, those are not cached.
+
+static const size_t LAYER_CACHE_DEFAULT_SIZE = 64 << 20;
+static const float LAYER_MIN_OVERDRAW = 1.25f;  // pixels drawn per pixel of the bounds below which drawing beats compositing
+
+// One draw list, 0xTTRRGGBB with (x1 - x0) pixels per row
+struct raster_layer_t {
+  uint64_t key;
+  rect_t bounds;
+  std::vector<uint32_t> pixels;         // empty until the list was seen unchanged twice
+  uint32_t frame;                       // last used
+  bool skip;                            // always draw the list, see LAYER_MIN_OVERDRAW
+};
+
+struct raster_layers_t {
+  std::vector<raster_layer_t> layers;
+  std::vector<int32_t> lists;           // layer of each draw list this frame, -1 to draw the list
+  size_t bytes = 0;                     // of the built layers
+  uint32_t frame = 0;
+};
+
+// Composite the part of a layer inside 'clip'
+static void draw_layer(const raster_target_t &rt, const raster_layer_t &layer, const rect_t &clip)
+{
+    const rect_t r = intersect(clip, layer.bounds);
+    if (r.empty())
+        return;
+    const int32_t count = r.x1 - r.x0;
+    const int32_t width = layer.bounds.x1 - layer.bounds.x0;
+    if (rt.counts) {
+        raster_count_t &c = rt.counts[rt.list];
+        c.tested += uint64_t(count) * uint64_t(r.y1 - r.y0);
+        c.written += uint64_t(count) * uint64_t(r.y1 - r.y0);
+    }
+    for (int32_t y = r.y0; y < r.y1; y++) {
+        const size_t offset = size_t(y - layer.bounds.y0) * width + (r.x0 - layer.bounds.x0);
+        rt.kernels->composite(target_row(rt, r.x0, y, count), &layer.pixels[offset], count);
+        target_row_done(rt, r.x0, y, count);
+    }
+}
+
+// Rasterize a whole draw list into 'rt', restricted to 'bounds'
+static void draw_list(
+    const raster_target_t &rt,
+    const ImDrawList *list,
+    std::vector<texture_t> &textures,
+    const ImVec2 &clip_off,
+    const ImVec2 &clip_scale,
+    const rect_t &bounds)
+{
+    const ImDrawIdx *idx = list->IdxBuffer.Data;
+    for (const ImDrawCmd &cmd : list->CmdBuffer) {
+        const ImDrawVert *vert = list->VtxBuffer.Data + cmd.VtxOffset;
+        const rect_t clip = intersect(project_rect(cmd.ClipRect, clip_off, clip_scale), bounds);
+        const texture_t *tex = find_texture(textures, cmd.TextureId);
+        if (!cmd.UserCallback && !clip.empty() && tex) {
+            for (uint32_t i = 0, size; i < cmd.ElemCount; i += size) {
+                size = prim_size(vert, idx + i, cmd.ElemCount - i);
+                draw_prim(rt, vert, idx + i, size, *tex, clip);
+            }
+        }
+        idx += cmd.ElemCount;
+    }
+}
+
+// Rough number of pixels drawn by a list (triangles count half their bounding box)
+static float list_pixels(const ImDrawList *list, const ImVec2 &clip_off, const ImVec2 &clip_scale, const rect_t &bounds)
+{
+    const ImDrawIdx *idx = list->IdxBuffer.Data;
+    float pixels = 0.f;
+    for (const ImDrawCmd &cmd : list->CmdBuffer) {
+        const ImDrawVert *vert = list->VtxBuffer.Data + cmd.VtxOffset;
+        const rect_t clip = intersect(project_rect(cmd.ClipRect, clip_off, clip_scale), bounds);
+        for (uint32_t i = 0, size; i < cmd.ElemCount && !clip.empty(); i += size) {
+            size = prim_size(vert, idx + i, cmd.ElemCount - i);
+            const ImDrawVert & v0 = vert[idx[i+0]];
+            const ImDrawVert & v1 = vert[idx[i+1]];
+            const ImDrawVert & v2 = vert[idx[i+2]];
+            const rect_t bb = intersect(clip, triangle_bounds(
+                vec2f_t{v0.pos.x, v0.pos.y},
+                vec2f_t{v1.pos.x, v1.pos.y},
+                vec2f_t{v2.pos.x, v2.pos.y}));
+            if (!bb.empty())
+                pixels += float(bb.x1 - bb.x0) * float(bb.y1 - bb.y0) * (size == 6 ? 1.f : .5f);
+        }
+        idx += cmd.ElemCount;
+    }
+    return pixels;
+}
+
+static void build_layer(
+    raster_layer_t &layer,
+    const raster_target_t &target,
+    const ImDrawList *list,
+    std::vector<texture_t> &textures,
+    const ImVec2 &clip_off,
+    const ImVec2 &clip_scale)
+{
+    const int32_t width = layer.bounds.x1 - layer.bounds.x0;
+    const size_t size = size_t(width) * (layer.bounds.y1 - layer.bounds.y0);
+    std::vector<uint32_t> white(size, 0xffffff);
+    layer.pixels.assign(size, 0);
+    // BGRA32 rows at the layer position, everything else as the target
+    raster_target_t rt = target;
+    rt.x0 = layer.bounds.x0;
+    rt.y0 = layer.bounds.y0;
+    rt.pitch = uint32_t(width) * 4;
+    rt.bpp = 4;
+    rt.load = NULL;
+    rt.store = NULL;
+    rt.pixels = (uint8_t*)layer.pixels.data();
+    rt.counts = NULL;     // not part of drawing the frame
+    draw_list(rt, list, textures, clip_off, clip_scale, layer.bounds);
+    rt.pixels = (uint8_t*)white.data();
+    draw_list(rt, list, textures, clip_off, clip_scale, layer.bounds);
+    for (size_t i = 0; i < size; i++) {
+        const uint32_t black = layer.pixels[i] & 0xffffff;
+        layer.pixels[i] = black | ((((white[i] >> 8) & 0xff) - ((black >> 8) & 0xff)) << 24);
+    }
+}
+
+static size_t layer_bytes(const raster_layer_t &layer)
+{
+    return layer.pixels.size() * sizeof(uint32_t);
+}
+
+// Drop the least recently used layers not needed this frame until 'size' more bytes fit
+static bool reserve_layers(raster_layers_t &cache, size_t size, size_t budget)
+{
+    while (cache.bytes + size > budget) {
+        raster_layer_t *oldest = NULL;
+        for (raster_layer_t &layer : cache.layers) {
+            if (!layer.pixels.empty() && layer.frame != cache.frame && (!oldest || layer.frame < oldest->frame))
+                oldest = &layer;
+        }
+        if (!oldest)
+            return false;
+        cache.bytes -= layer_bytes(*oldest);
+        std::vector<uint32_t>().swap(oldest->pixels);
+    }
+    return true;
+}
+
+// Find, or build, the layer of each draw list
+static void update_layers(
+    raster_layers_t &cache,
+    const raster_target_t &target,
+    std::vector<texture_t> &textures,
+    const rect_t &viewport,
+    ImDrawData *draw_data,
+    size_t budget)
+{
+    const ImVec2 clip_off = draw_data->DisplayPos;
+    const ImVec2 clip_scale = draw_data->FramebufferScale;
+    const texture_t &font = textures[0];
+    uint64_t frame_key = hash_bytes(0xcbf29ce484222325ull, &clip_off, sizeof(ImVec2));
+    frame_key = hash_bytes(frame_key, &clip_scale, sizeof(ImVec2));
+    frame_key = hash_mix(frame_key, uint64_t(uintptr_t(font.tex)));
+    frame_key = hash_mix(frame_key, (uint64_t(font.w) << 32) | font.h);
+
+    // forget the lists that were seen once and not again
+    cache.frame++;
+    std::vector<raster_layer_t> &layers = cache.layers;
+    layers.erase(std::remove_if(layers.begin(), layers.end(), [&](const raster_layer_t &layer) {
+        return layer.pixels.empty() && layer.frame + 1 < cache.frame;
+    }), layers.end());
+
+    cache.lists.assign(draw_data->CmdListsCount, -1);
+    for (int n = 0; n < draw_data->CmdListsCount; n++) {
+        const ImDrawList *list = draw_data->CmdLists[n];
+        raster_list_state_t state;
+        if (!hash_list(list, textures, viewport, clip_off, clip_scale, state) || state.bounds.empty())
+            continue;
+        const size_t area = size_t(state.bounds.x1 - state.bounds.x0) * (state.bounds.y1 - state.bounds.y0);
+        const uint64_t key = hash_bytes(hash_mix(frame_key, state.hash), &state.bounds, sizeof(rect_t));
+        int32_t i = 0;
+        while (i < int32_t(layers.size()) && layers[i].key != key)
+            i++;
+        if (i == int32_t(layers.size())) {
+            layers.push_back(raster_layer_t{key, state.bounds, {}, cache.frame, false});
+            continue;
+        }
+        raster_layer_t &layer = layers[i];
+        layer.frame = cache.frame;
+        if (layer.skip)
+            continue;
+        if (layer.pixels.empty()) {
+            if (list_pixels(list, clip_off, clip_scale, state.bounds) < LAYER_MIN_OVERDRAW * float(area)) {
+                layer.skip = true;
+                continue;
+            }
+            const size_t size = area * sizeof(uint32_t);
+            if (!reserve_layers(cache, size, budget))
+                continue;
+            build_layer(layer, target, list, textures, clip_off, clip_scale);
+            cache.bytes += layer_bytes(layer);
+        }
+        cache.lists[n] = i;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Tiled rendering
+//-----------------------------------------------------------------------------
+// When ImGuiImplRasterinfo::threads is non zero, primitives are first binned into
+// screen tiles in submission order, then the tiles are rasterized in parallel.
+// Each tile only ever writes its own pixels and replays its bin in order, so the
+// output is identical to the serial path.
+
+// A draw command as seen by the tiles, or a layer to composite
+struct raster_cmd_t {
+  rect_t clip;
+  const ImDrawVert *vtx;
+  const texture_t *tex;
+  const raster_layer_t *layer;
+  int32_t list;             // index of its draw list
+};
+
+// A primitive reference in a tile bin, size 0 for the layer of the command
+struct raster_prim_t {
+  uint32_t cmd;
+  uint32_t size;
+  const ImDrawIdx *idx;
+};
+
+struct raster_tile_t {
+  rect_t rect;
+  std::vector<raster_prim_t> prims;
+};
+
+struct raster_pool_t {
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable wake;     // signalled when a frame is ready to render
+  std::condition_variable done;     // signalled when the last worker finished a frame
+  uint32_t frame = 0;
+  uint32_t busy = 0;
+  bool quit = false;
+  std::atomic<int32_t> next{0};     // next entry of 'active' to render
+};
+
+// Tiles of one context, the workers render into 'target'
+struct raster_tiles_t {
+  raster_target_t target;
+  std::vector<std::vector<raster_count_t> > counts;   // per thread and draw list with ImGuiImplRasterFlags_Stats
+  std::vector<raster_cmd_t> cmds;
+  std::vector<raster_tile_t> tiles;
+  std::vector<int32_t> active;      // tiles with a non empty bin this frame
+  int32_t tiles_x = 0, tiles_y = 0;
+  raster_pool_t pool;
+};
+
+static void render_tile(const raster_tiles_t &rt, raster_tile_t &tile, raster_count_t *counts)
+{
+    raster_target_t target = rt.target;
+    target.counts = counts;
+    for (const raster_prim_t &p : tile.prims) {
+        const raster_cmd_t &cmd = rt.cmds[p.cmd];
+        target.list = cmd.list;
+        if (p.size == 0)
+            draw_layer(target, *cmd.layer, intersect(cmd.clip, tile.rect));
+        else
+            draw_prim(target, cmd.vtx, p.idx, p.size, *cmd.tex, intersect(cmd.clip, tile.rect));
+    }
+    tile.prims.clear();
+}
+
+// 'thread' 0 is the calling thread, workers count from 1
+static void render_tiles(raster_tiles_t &rt, uint32_t thread)
+{
+    raster_count_t *counts = rt.counts.empty() ? NULL : rt.counts[thread].data();
+    const int32_t count = int32_t(rt.active.size());
+    for (;;) {
+        const int32_t i = rt.pool.next.fetch_add(1);
+        if (i >= count)
+            break;
+        render_tile(rt, rt.tiles[rt.active[i]], counts);
+    }
+}
+
+static void worker_main(raster_tiles_t *rt, uint32_t thread)
+{
+    raster_pool_t &pool = rt->pool;
+    uint32_t frame = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(pool.mutex);
+            pool.wake.wait(lock, [&] { return pool.quit || pool.frame != frame; });
+            if (pool.quit)
+                return;
+            frame = pool.frame;
+        }
+        render_tiles(*rt, thread);
+        {
+            std::lock_guard<std::mutex> lock(pool.mutex);
+            if (--pool.busy == 0)
+                pool.done.notify_one();
+        }
+    }
+}
+
+static void create_tiles(raster_tiles_t &rt, const rect_t &viewport, uint32_t threads)
+{
+    rt.tiles_x = (viewport.x1 + TILE_SIZE - 1) / TILE_SIZE;
+    rt.tiles_y = (viewport.y1 + TILE_SIZE - 1) / TILE_SIZE;
+    rt.tiles.resize(rt.tiles_x * rt.tiles_y);
+    for (int32_t ty = 0; ty < rt.tiles_y; ty++) {
+        for (int32_t tx = 0; tx < rt.tiles_x; tx++) {
+            const rect_t r = {tx * TILE_SIZE, ty * TILE_SIZE, (tx + 1) * TILE_SIZE, (ty + 1) * TILE_SIZE};
+            rt.tiles[ty * rt.tiles_x + tx].rect = intersect(r, viewport);
+        }
+    }
+    // the calling thread renders too
+    for (uint32_t i = 1; i < threads; i++)
+        rt.pool.workers.emplace_back(worker_main, &rt, i);
+}
+
+static void destroy_tiles(raster_tiles_t &rt)
+{
+    {
+        std::lock_guard<std::mutex> lock(rt.pool.mutex);
+        rt.pool.quit = true;
+    }
+    rt.pool.wake.notify_all();
+    for (std::thread &t : rt.pool.workers)
+        t.join();
+    rt.pool.workers.clear();
+    rt.pool.quit = false;
+    rt.tiles.clear();
+    rt.cmds.clear();
+    rt.active.clear();
+    rt.counts.clear();
+}
+
+// Bin the primitives of a draw command, 'key' is the one of its first primitive.
+// Returns the number of triangles left out of every tile. With statistics ('target' has
+// counters), the binned ones are also counted as rasterized or culled, once each.
+static uint32_t bin_cmd(
+    raster_tiles_t &rt,
+    const raster_target_t &target,
+    const ImDrawVert *vert,
+    const ImDrawIdx *idx,
+    uint32_t count,
+    const texture_t &tex,
+    const rect_t &clip,
+    const raster_occlusion_t &occ,
+    uint64_t key)
+{
+    const uint32_t cmd = uint32_t(rt.cmds.size());
+    rt.cmds.push_back(raster_cmd_t{clip, vert, &tex, NULL, int32_t(key >> 32)});
+    uint32_t culled = 0;
+    for (uint32_t i = 0, size; i < count; i += size) {
+        size = prim_size(vert, idx + i, count - i);
+        // a rectangle is bound by (a, b, c) as well
+        const ImDrawVert & v0 = vert[idx[i+0]];
+        const ImDrawVert & v1 = vert[idx[i+1]];
+        const ImDrawVert & v2 = vert[idx[i+2]];
+        const rect_t bb = intersect(clip, triangle_bounds(
+            vec2f_t{v0.pos.x, v0.pos.y},
+            vec2f_t{v1.pos.x, v1.pos.y},
+            vec2f_t{v2.pos.x, v2.pos.y}));
+        if (bb.empty()) {
+            culled += size / 3;
+            continue;
+        }
+        const int32_t tx0 = bb.x0 / TILE_SIZE, tx1 = (bb.x1 - 1) / TILE_SIZE;
+        const int32_t ty0 = bb.y0 / TILE_SIZE, ty1 = (bb.y1 - 1) / TILE_SIZE;
+        bool binned = false;
+        for (int32_t ty = ty0; ty <= ty1; ty++) {
+            for (int32_t tx = tx0; tx <= tx1; tx++) {
+                const int32_t n = ty * rt.tiles_x + tx;
+                if (!occ.keys.empty() && occ.keys[n] > key + i)
+                    continue;
+                raster_tile_t &tile = rt.tiles[n];
+                if (tile.prims.empty())
+                    rt.active.push_back(n);
+                tile.prims.push_back(raster_prim_t{cmd, size, idx + i});
+                binned = true;
+            }
+        }
+        if (!binned || (target.counts && !prim_visible(target, vert, idx + i, size, tex, clip)))
+            culled += size / 3;
+        else if (target.counts)
+            target.counts[target.list].rasterized += size / 3;
+    }
+    return culled;
+}
+
+// Bin the composition of a layer, 'key' is the one of the last primitive of its draw list
+static void bin_layer(raster_tiles_t &rt, const raster_layer_t &layer, const rect_t &clip, const raster_occlusion_t &occ, uint64_t key)
+{
+    const rect_t bb = intersect(clip, layer.bounds);
+    if (bb.empty())
+        return;
+    const uint32_t cmd = uint32_t(rt.cmds.size());
+    rt.cmds.push_back(raster_cmd_t{bb, NULL, NULL, &layer, int32_t(key >> 32)});
+    for (int32_t ty = bb.y0 / TILE_SIZE; ty <= (bb.y1 - 1) / TILE_SIZE; ty++) {
+        for (int32_t tx = bb.x0 / TILE_SIZE; tx <= (bb.x1 - 1) / TILE_SIZE; tx++) {
+            const int32_t n = ty * rt.tiles_x + tx;
+            if (!occ.keys.empty() && occ.keys[n] > key)
+                continue;
+            raster_tile_t &tile = rt.tiles[n];
+            if (tile.prims.empty())
+                rt.active.push_back(n);
+            tile.prims.push_back(raster_prim_t{cmd, 0, NULL});
+        }
+    }
+}
+
+static void flush_tiles(raster_tiles_t &rt, const raster_target_t &target)
+{
+    if (!rt.active.empty()) {
+        rt.target = target;
+        rt.pool.next = 0;
+        {
+            std::lock_guard<std::mutex> lock(rt.pool.mutex);
+            rt.pool.busy = uint32_t(rt.pool.workers.size());
+            rt.pool.frame++;
+        }
+        rt.pool.wake.notify_all();
+        render_tiles(rt, 0);
+        std::unique_lock<std::mutex> lock(rt.pool.mutex);
+        rt.pool.done.wait(lock, [&] { return rt.pool.busy == 0; });
+    }
+    rt.active.clear();
+    rt.cmds.clear();
+}
+
+//-----------------------------------------------------------------------------
+// Frame streaming
+//-----------------------------------------------------------------------------
+// ImGui_ImplRaster_BeginStream() writes every rendered frame to a file descriptor.
+// The render thread only copies the target into the pending frame, a writer thread
+// swaps it with its own buffer, converts and writes it. If the writer is still busy
+// with the previous frame when the next one is pending, the pending one is replaced
+// (and counted as dropped), so rendering never waits for I/O.
+
+struct raster_stream_frame_t {
+  std::vector<uint8_t> pixels;      // rows of the target, tightly packed, in its format
+  int64_t time = 0;                 // microseconds since ImGui_ImplRaster_BeginStream()
+};
+
+struct raster_stream_t {
+  int fd = -1;
+  ImGuiImplRasterStreamFormat format;
+  ImGuiImplRasterStreamFlags flags;
+  int32_t width, height;
+  uint32_t bpp;
+  void (*load)(const uint8_t *src, int32_t count, uint32_t *out);   // see raster_target_t
+  std::chrono::steady_clock::time_point start;
+  uint64_t last_hash;               // ImGuiImplRasterStreamFlags_ChangedOnly without dirty rectangles
+  uint32_t frames;                  // submitted
+  uint32_t dropped;
+  std::thread writer;
+  std::mutex mutex;
+  std::condition_variable wake;
+  raster_stream_frame_t pending;
+  bool has_pending = false;
+  bool quit = false;
+  bool failed = false;              // a write failed, the writer stopped
+};
+
+static bool write_all(int fd, const void *data, size_t size)
+{
+    const char *p = (const char*)data;
+    while (size > 0) {
+#if defined(_WIN32)
+        const int n = _write(fd, p, unsigned(std::min(size, size_t(1) << 30)));
+#else
+        const ssize_t n = write(fd, p, size);
+        if (n < 0 && errno == EINTR)
+            continue;
+#endif
+        if (n <= 0)
+            return false;
+        p += n;
+        size -= size_t(n);
+    }
+    return true;
+}
+
+// Full range BT.601 (JPEG) luma, 8 bit weights adding up to 256
+static inline uint8_t rgb_luma(uint32_t c) {
+  return uint8_t((29 * (c & 0xff) + 150 * ((c >> 8) & 0xff) + 77 * ((c >> 16) & 0xff) + 128) >> 8);
+}
+
+// Chroma from the sums of a 2x2 block of channels
+static inline uint8_t rgb_cb(int32_t b, int32_t g, int32_t r) {
+  return uint8_t(std::min((128 * b - 85 * g - 43 * r + (128 << 10) + 512) >> 10, 255));
+}
+
+static inline uint8_t rgb_cr(int32_t b, int32_t g, int32_t r) {
+  return uint8_t(std::min((128 * r - 107 * g - 21 * b + (128 << 10) + 512) >> 10, 255));
+}
+
+// Two rows of 0xXXRRGGBB pixels to two rows of luma and one of each chroma, starting at pixel 'x'
+// (even). An odd last column is paired with itself, as is an odd last row by the caller.
+static void yuv420_rows_scalar(const uint32_t *row0, const uint32_t *row1, int32_t x, int32_t width, uint8_t *y0, uint8_t *y1, uint8_t *u, uint8_t *v)
+{
+    for (; x < width; x += 2) {
+        const int32_t x1 = std::min(x + 1, width - 1);
+        const uint32_t p[4] = {row0[x], row0[x1], row1[x], row1[x1]};
+        y0[x] = rgb_luma(p[0]);
+        y1[x] = rgb_luma(p[2]);
+        if (x1 != x) {
+            y0[x1] = rgb_luma(p[1]);
+            y1[x1] = rgb_luma(p[3]);
+        }
+        int32_t b = 0, g = 0, r = 0;
+        for (uint32_t c : p) {
+            b += c & 0xff;
+            g += (c >> 8) & 0xff;
+            r += (c >> 16) & 0xff;
+        }
+        u[x / 2] = rgb_cb(b, g, r);
+        v[x / 2] = rgb_cr(b, g, r);
+    }
+}
+
+#if defined(IMGUI_IMPL_RASTER_SSE2)
+
+// Sum the two 32 bit halves of each 64 bit lane of madd results of 'a' and 'b', giving 4 values
+static inline __m128i sum_pairs_sse2(__m128i a, __m128i b) {
+    a = _mm_add_epi32(a, _mm_srli_epi64(a, 32));
+    b = _mm_add_epi32(b, _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi64(_mm_shuffle_epi32(a, _MM_SHUFFLE(3, 1, 2, 0)), _mm_shuffle_epi32(b, _MM_SHUFFLE(3, 1, 2, 0)));
+}
+
+// Luma of 4 pixels, in the 32 bit lanes
+static inline __m128i luma_sse2(__m128i p) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i w = _mm_setr_epi16(29, 150, 77, 0, 29, 150, 77, 0);
+    const __m128i s = sum_pairs_sse2(_mm_madd_epi16(_mm_unpacklo_epi8(p, zero), w), _mm_madd_epi16(_mm_unpackhi_epi8(p, zero), w));
+    return _mm_srli_epi32(_mm_add_epi32(s, _mm_set1_epi32(128)), 8);
+}
+
+// The same as yuv420_rows_scalar(), 8 pixels at a time
+static void yuv420_rows_sse2(const uint32_t *row0, const uint32_t *row1, int32_t width, uint8_t *y0, uint8_t *y1, uint8_t *u, uint8_t *v)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i wb = _mm_setr_epi16(128, -85, -43, 0, 128, -85, -43, 0);
+    const __m128i wr = _mm_setr_epi16(-21, -107, 128, 0, -21, -107, 128, 0);
+    const __m128i bias = _mm_set1_epi32((128 << 10) + 512);
+    int32_t x = 0;
+    for (; x + 8 <= width; x += 8) {
+        const __m128i a0 = _mm_loadu_si128((const __m128i*)(row0 + x)), a1 = _mm_loadu_si128((const __m128i*)(row0 + x + 4));
+        const __m128i b0 = _mm_loadu_si128((const __m128i*)(row1 + x)), b1 = _mm_loadu_si128((const __m128i*)(row1 + x + 4));
+        _mm_storel_epi64((__m128i*)(y0 + x), _mm_packus_epi16(_mm_packs_epi32(luma_sse2(a0), luma_sse2(a1)), zero));
+        _mm_storel_epi64((__m128i*)(y1 + x), _mm_packus_epi16(_mm_packs_epi32(luma_sse2(b0), luma_sse2(b1)), zero));
+        // channel sums of the 2x2 blocks, 16 bit: two blocks per register
+        const __m128i c0 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+        const __m128i c1 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+        const __m128i c2 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+        const __m128i c3 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+        const __m128i s01 = _mm_unpacklo_epi64(_mm_add_epi16(c0, _mm_srli_si128(c0, 8)), _mm_add_epi16(c1, _mm_srli_si128(c1, 8)));
+        const __m128i s23 = _mm_unpacklo_epi64(_mm_add_epi16(c2, _mm_srli_si128(c2, 8)), _mm_add_epi16(c3, _mm_srli_si128(c3, 8)));
+        const __m128i cb = _mm_srai_epi32(_mm_add_epi32(sum_pairs_sse2(_mm_madd_epi16(s01, wb), _mm_madd_epi16(s23, wb)), bias), 10);
+        const __m128i cr = _mm_srai_epi32(_mm_add_epi32(sum_pairs_sse2(_mm_madd_epi16(s01, wr), _mm_madd_epi16(s23, wr)), bias), 10);
+        const __m128i uv = _mm_packus_epi16(_mm_packs_epi32(cb, cr), zero);
+        const int32_t cb4 = _mm_cvtsi128_si32(uv), cr4 = _mm_cvtsi128_si32(_mm_srli_si128(uv, 4));
+        memcpy(u + x / 2, &cb4, 4);
+        memcpy(v + x / 2, &cr4, 4);
+    }
+    yuv420_rows_scalar(row0, row1, x, width, y0, y1, u, v);
+}
+
+#endif // IMGUI_IMPL_RASTER_SSE2
 
-#if defined(_MSC_VER) && _MSC_VER <= 1500 // MSVC 2008 or earlier
-#include <stddef.h>     // intptr_t
+static void yuv420_rows(const uint32_t *row0, const uint32_t *row1, int32_t width, uint8_t *y0, uint8_t *y1, uint8_t *u, uint8_t *v)
+{
+#if defined(IMGUI_IMPL_RASTER_SSE2)
+    yuv420_rows_sse2(row0, row1, width, y0, y1, u, v);
 #else
-#include <stdint.h>     // intptr_t
+    yuv420_rows_scalar(row0, row1, 0, width, y0, y1, u, v);
 #endif
-#include <algorithm>
+}
 
-struct rect_t {
-  int32_t x0, y0, x1, y1;
-};
+// Convert a frame to the stream format into 'out'
+static void encode_frame(const raster_stream_t &stream, const raster_stream_frame_t &frame, std::vector<uint8_t> &out, std::vector<uint32_t> &rows)
+{
+    const int32_t w = stream.width, h = stream.height;
+    const bool changed_only = (stream.flags & ImGuiImplRasterStreamFlags_ChangedOnly) != 0;
+    char header[96];
+    int header_size = 0;
+    size_t size = 0;
+    switch (stream.format) {
+    case ImGuiImplRasterStreamFormat_Y4M:
+        header_size = changed_only ? snprintf(header, sizeof(header), "FRAME Xt=%lld\n", (long long)frame.time) : snprintf(header, sizeof(header), "FRAME\n");
+        size = size_t(w) * h + size_t((w + 1) / 2) * ((h + 1) / 2) * 2;
+        break;
+    case ImGuiImplRasterStreamFormat_PPM:
+        header_size = snprintf(header, sizeof(header), "P6\n# t=%lld\n%d %d\n255\n", (long long)frame.time, int(w), int(h));
+        size = size_t(w) * h * 3;
+        break;
+    default:
+        size = size_t(w) * h * 4;
+        break;
+    }
+    out.resize(header_size + size);
+    memcpy(out.data(), header, header_size);
+    uint8_t *dst = out.data() + header_size;
 
-struct vec2f_t {
+    // rows of 0xXXRRGGBB pixels
+    rows.resize(size_t(w) * 2);
+    const size_t pitch = size_t(w) * stream.bpp;
+    auto row = [&](int32_t y, uint32_t *tmp) -> const uint32_t* {
+        const uint8_t *src = frame.pixels.data() + pitch * y;
+        if (!stream.load)
+            return (const uint32_t*)src;
+        stream.load(src, w, tmp);
+        return tmp;
+    };
+    if (stream.format == ImGuiImplRasterStreamFormat_Y4M) {
+        uint8_t *u = dst + size_t(w) * h;
+        uint8_t *v = u + size_t((w + 1) / 2) * ((h + 1) / 2);
+        for (int32_t y = 0; y < h; y += 2) {
+            const int32_t y1 = std::min(y + 1, h - 1);
+            // an odd last row writes its luma twice, in place
+            yuv420_rows(row(y, rows.data()), row(y1, rows.data() + w), w, dst + size_t(w) * y, dst + size_t(w) * y1,
+                u + size_t((w + 1) / 2) * (y / 2), v + size_t((w + 1) / 2) * (y / 2));
+        }
+        return;
+    }
+    const bool rgb = stream.format == ImGuiImplRasterStreamFormat_PPM;
+    for (int32_t y = 0; y < h; y++) {
+        const uint32_t *src = row(y, rows.data());
+        for (int32_t x = 0; x < w; x++) {
+            const uint32_t c = src[x];
+            *dst++ = uint8_t(c >> 16);
+            *dst++ = uint8_t(c >> 8);
+            *dst++ = uint8_t(c);
+            if (!rgb)
+                *dst++ = 255;
+        }
+    }
+}
 
-  void operator += (const vec2f_t &p) {
-    x += p.x; y += p.y;
-  }
+static void stream_main(raster_stream_t *stream)
+{
+    raster_stream_frame_t frame;
+    std::vector<uint8_t> out;
+    std::vector<uint32_t> rows;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(stream->mutex);
+            stream->wake.wait(lock, [&] { return stream->quit || stream->has_pending; });
+            if (!stream->has_pending)
+                return;
+            std::swap(frame, stream->pending);
+            stream->has_pending = false;
+        }
+        encode_frame(*stream, frame, out, rows);
+        if (!write_all(stream->fd, out.data(), out.size())) {
+            std::lock_guard<std::mutex> lock(stream->mutex);
+            stream->failed = true;
+            return;
+        }
+    }
+}
 
-  float x, y;
-};
+static bool begin_stream(raster_stream_t &stream, const raster_target_t &target, int32_t width, int32_t height, int fd, ImGuiImplRasterStreamFormat format, ImGuiImplRasterStreamFlags flags, int fps)
+{
+    stream.fd = fd;
+    stream.format = format;
+    stream.flags = flags;
+    stream.width = width;
+    stream.height = height;
+    stream.bpp = target.bpp;
+    stream.load = target.load;
+    stream.start = std::chrono::steady_clock::now();
+    stream.frames = 0;
+    stream.dropped = 0;
+    stream.has_pending = false;
+    stream.quit = false;
+    stream.failed = false;
+    if (format == ImGuiImplRasterStreamFormat_Y4M) {
+        char header[96];
+        const int size = snprintf(header, sizeof(header), "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", int(width), int(height), std::max(fps, 1));
+        if (!write_all(fd, header, size)) {
+            stream.fd = -1;
+            return false;
+        }
+    }
+    stream.writer = std::thread(stream_main, &stream);
+    return true;
+}
 
-bool operator == (const ImVec2 &a, const ImVec2 &b) {
-  return a.x == b.x && a.y == b.y;
+// Queue the frame in 'target', 'changed' is false if the dirty rectangles say it did not change
+static void stream_frame(raster_stream_t &stream, const raster_target_t &target, int32_t width, int32_t height, bool changed)
+{
+    if (width != stream.width || height != stream.height) {
+        stream.dropped++;
+        return;
+    }
+    const size_t pitch = size_t(width) * stream.bpp;
+    if (stream.flags & ImGuiImplRasterStreamFlags_ChangedOnly) {
+        if (!changed && stream.frames > 0)
+            return;
+        uint64_t h = 0xcbf29ce484222325ull;
+        for (int32_t y = 0; y < height; y++)
+            h = hash_bytes(h, target.pixels + size_t(y) * target.pitch, pitch);
+        if (stream.frames > 0 && h == stream.last_hash)
+            return;
+        stream.last_hash = h;
+    }
+    std::lock_guard<std::mutex> lock(stream.mutex);
+    if (stream.failed)
+        return;
+    if (stream.has_pending)
+        stream.dropped++;
+    raster_stream_frame_t &frame = stream.pending;
+    frame.pixels.resize(pitch * height);
+    for (int32_t y = 0; y < height; y++)
+        memcpy(frame.pixels.data() + pitch * y, target.pixels + size_t(y) * target.pitch, pitch);
+    frame.time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - stream.start).count();
+    stream.has_pending = true;
+    stream.frames++;
+    stream.wake.notify_one();
 }
 
-struct vec3f_t {
+// Write the pending frame, stop the writer, returns the number of frames dropped
+static int end_stream(raster_stream_t &stream)
+{
+    if (stream.fd < 0)
+        return 0;
+    {
+        std::lock_guard<std::mutex> lock(stream.mutex);
+        stream.quit = true;
+    }
+    stream.wake.notify_one();
+    stream.writer.join();
+    stream.fd = -1;
+    return int(stream.dropped);
+}
 
-  void operator += (const vec3f_t &p) {
-    x += p.x; y += p.y; z += p.z;
-  }
+//-----------------------------------------------------------------------------
+// Statistics
+//-----------------------------------------------------------------------------
+// ImGuiImplRasterFlags_Stats counts the triangles and pixels each draw list costs and
+// times the phases of a frame. Each thread counts into its own raster_count_t per draw
+// list (see raster_target_t::counts), they are added up once the frame is drawn.
+// ImGuiImplRasterFlags_OverdrawHeatmap draws into a write counter per pixel instead of
+// the target, then fills the target with a colour per count.
 
-  float x, y, z;
+struct raster_stats_t {
+  ImGuiImplRasterStats out;
+  std::vector<ImGuiImplRasterListStats> lists;
+  std::vector<raster_count_t> counts;   // per draw list, serial rendering
+  std::vector<uint16_t> heat;           // writes per pixel of the viewport
+  std::chrono::steady_clock::time_point phase;  // start of the phase being timed
+  bool heatmap = false;                 // the last frame was a heatmap
 };
 
-struct texture_t {
-  uint32_t w, h;
-  const uint8_t *tex;
-};
+// 0, 1, 2, 3, 4, 5 and more writes
+static const uint32_t g_HeatColours[] = { 0x000000, 0x1840c0, 0x18b050, 0xe0e020, 0xf08010, 0xe02010, 0xffffff };
+static const int HEAT_LEVELS = int(sizeof(g_HeatColours) / sizeof(g_HeatColours[0]));
 
-static ImGuiImplRasterinfo g_Info;
-static ImVec4 g_ClipRect;
-static uint32_t g_FontTexture;
-static rect_t g_viewport;
-static rect_t g_clip;
-static texture_t g_font;
+// Heatmap rows: the kernels draw white with the vertex alpha over 0xff000000 pixels. Any
+// write lowers the top byte (opaque ones clear it, blends scale it by 1 - alpha).
+static void load_heat(const uint8_t *, int32_t count, uint32_t *out)
+{
+    std::fill_n(out, count, 0xff000000u);
+}
 
-static inline float orient2d(
-    const vec2f_t& a,
-    const vec2f_t& b,
-    const vec2f_t& c)
+static void store_heat(uint8_t *dst, int32_t, int32_t, int32_t count, const uint32_t *in)
 {
-    return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    uint16_t *writes = (uint16_t*)dst;
+    for (int32_t i = 0; i < count; i++)
+        if ((in[i] >> 24) != 0xff && writes[i] != 0xffff)
+            writes[i]++;
 }
 
-static inline uint32_t swizzle(uint32_t x) {
-  return ((x >> 16) & 0xff) | ((x << 16) & 0xff0000) | (x & 0xff00);
+// A target counting the writes into 'stats.heat' instead of drawing into 'rt'
+static raster_target_t heat_target(raster_stats_t &stats, const raster_target_t &rt, const rect_t &viewport)
+{
+    stats.heat.assign(size_t(viewport.x1) * viewport.y1, 0);
+    raster_target_t heat = rt;
+    heat.pixels = (uint8_t*)stats.heat.data();
+    heat.x0 = 0;
+    heat.y0 = 0;
+    heat.pitch = uint32_t(viewport.x1) * 2;
+    heat.bpp = 2;
+    heat.load = load_heat;
+    heat.store = store_heat;
+    heat.white = 0xffffff;
+    heat.kernels = &g_kernels;
+    return heat;
 }
 
-void draw_triangle(
-    const vec2f_t& v0,
-    const vec2f_t& v1,
-    const vec2f_t& v2,
-    uint32_t rgb)
-{
-    // triangle bounds
-    int32_t minx = int32_t(std::min({v0.x, v1.x, v2.x - 1}));
-    int32_t maxx = int32_t(std::max({v0.x, v1.x, v2.x + 1}));
-    int32_t miny = int32_t(std::min({v0.y, v1.y, v2.y - 1}));
-    int32_t maxy = int32_t(std::max({v0.y, v1.y, v2.y + 1}));
-    // clip min point to screen
-    minx = std::max<int32_t>({minx + 0, g_viewport.x0, g_clip.x0});
-    miny = std::max<int32_t>({miny + 0, g_viewport.y0, g_clip.y0});
-    maxx = std::min<int32_t>({maxx + 1, g_viewport.x1, g_clip.x1});
-    maxy = std::min<int32_t>({maxy + 1, g_viewport.y1, g_clip.y1});
-    // barycentric x step
-    const vec3f_t sx = {
-        (v0.y - v1.y),  // A01
-        (v1.y - v2.y),  // A12
-        (v2.y - v0.y)   // A20
-    };
-    // barycentric y step
-    const vec3f_t sy = {
-        (v1.x - v0.x),  // B01
-        (v2.x - v1.x),  // B12
-        (v0.x - v2.x)   // B20
-    };
-    // barycentric start point
-    vec2f_t p = { float(minx) + .5f, float(miny) + .5f };
-    // barycentric value at start point
-    vec3f_t wy = {
-        orient2d(v0, v1, p), // W2 -> A01, B01
-        orient2d(v1, v2, p), // W0 -> A12, B12
-        orient2d(v2, v0, p), // W1 -> A20, B20
-    };
-    const uint32_t dst_pitch = g_Info.pitch;
-    const uint32_t colour = rgb;
-    uint32_t* pix = g_Info.pixels + miny * dst_pitch;
-    // rendering loop
-    for (int32_t py = miny; py < maxy; py++) {
-        vec3f_t wx = wy;
-        for (int32_t px = minx; px < maxx; px++) {
-            // If p is on or inside all edges, render pixel
-            if (wx.x >= 0 && wx.y >= 0 && wx.z >= 0) {
-#if 0
-                pix[px] = ((pix[px] >> 2) & 0x3f3f3f) +
-                           ((colour >> 1) & 0x7f7f7f) +
-                           ((colour >> 2) & 0x3f3f3f);
-#else
-                pix[px] = colour;
-#endif
-            }
-            // X step
-            wx += sx;
+static void resolve_heat(const raster_stats_t &stats, const raster_target_t &rt, const rect_t &viewport)
+{
+    const int32_t width = viewport.x1;
+    for (int32_t y = 0; y < viewport.y1; y++) {
+        const uint16_t *writes = &stats.heat[size_t(y) * width];
+        uint32_t *row = target_row(rt, 0, y, width);
+        for (int32_t x = 0; x < width; x++)
+            row[x] = g_HeatColours[std::min(int(writes[x]), HEAT_LEVELS - 1)];
+        target_row_done(rt, 0, y, width);
+    }
+}
+
+// Milliseconds since the last call
+static float stats_phase(raster_stats_t &stats)
+{
+    const auto now = std::chrono::steady_clock::now();
+    const float ms = std::chrono::duration<float, std::milli>(now - stats.phase).count();
+    stats.phase = now;
+    return ms;
+}
+
+static void begin_stats(raster_stats_t &stats, raster_tiles_t &tiles, uint32_t threads, const ImDrawData *draw_data)
+{
+    const size_t count = size_t(draw_data->CmdListsCount);
+    stats.phase = std::chrono::steady_clock::now();
+    stats.out = ImGuiImplRasterStats();
+    stats.lists.assign(count, ImGuiImplRasterListStats());
+    for (size_t n = 0; n < count; n++) {
+        ImGuiImplRasterListStats &list = stats.lists[n];
+        list.list = draw_data->CmdLists[n];
+        if (const char *name = draw_data->CmdLists[n]->_OwnerName)
+            snprintf(list.name, sizeof(list.name), "%s", name);
+    }
+    stats.counts.assign(count, raster_count_t());
+    if (threads)
+        tiles.counts.assign(threads, std::vector<raster_count_t>(count, raster_count_t()));
+}
+
+// Add up the counters of the threads
+static void end_stats(raster_stats_t &stats, raster_tiles_t &tiles)
+{
+    ImGuiImplRasterStats &out = stats.out;
+    for (size_t n = 0; n < stats.lists.size(); n++) {
+        raster_count_t c = stats.counts[n];
+        for (const std::vector<raster_count_t> &thread : tiles.counts) {
+            c.rasterized += thread[n].rasterized;
+            c.tested += thread[n].tested;
+            c.written += thread[n].written;
         }
-        // Y step
-        wy += sy;
-        pix += dst_pitch;
+        ImGuiImplRasterListStats &list = stats.lists[n];
+        list.triangles_rasterized = uint32_t(c.rasterized);
+        list.pixels_tested = c.tested;
+        list.pixels_written = c.written;
+        out.triangles_submitted += list.triangles_submitted;
+        out.triangles_culled += list.triangles_culled;
+        out.triangles_rasterized += list.triangles_rasterized;
+        out.pixels_tested += list.pixels_tested;
+        out.pixels_written += list.pixels_written;
     }
+    out.lists_count = int(stats.lists.size());
+    out.lists = stats.lists.empty() ? NULL : stats.lists.data();
+    tiles.counts.clear();
 }
 
-void draw_triangle(
-    const vec2f_t& v0,
-    const vec2f_t& v1,
-    const vec2f_t& v2,
-    const vec2f_t& t0,
-    const vec2f_t& t1,
-    const vec2f_t& t2,
-    const texture_t & tex)
-{
-    const uint8_t *t = (const uint8_t*)tex.tex;
-    const uint32_t tmask = (tex.w * tex.h) - 1;
-
-    // triangle bounds
-    int32_t minx = int32_t(std::min<float>({v0.x, v1.x, v2.x}));
-    int32_t maxx = int32_t(std::max<float>({v0.x, v1.x, v2.x}));
-    int32_t miny = int32_t(std::min<float>({v0.y, v1.y, v2.y}));
-    int32_t maxy = int32_t(std::max<float>({v0.y, v1.y, v2.y}));
-    // clip min point to screen
-    minx = std::max<int32_t>({minx + 0, g_viewport.x0, g_clip.x0});
-    miny = std::max<int32_t>({miny + 0, g_viewport.y0, g_clip.y0});
-    maxx = std::min<int32_t>({maxx + 1, g_viewport.x1, g_clip.x1});
-    maxy = std::min<int32_t>({maxy + 1, g_viewport.y1, g_clip.y1});
-    // the signed triangle areas
-    const float area = 1.f / ((v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y));
-    // reject back faces
-    if (area <= 0.f)
+//-----------------------------------------------------------------------------
+// Shared memory target
+//-----------------------------------------------------------------------------
+// ImGui_ImplRaster_CreateSharedTarget() maps a POSIX shared memory object holding an
+// ImGuiImplRasterSharedHeader and a ring of buffers, frame f is drawn into buffer
+// f % buffer_count. A slot's sequence is 0 while its buffer is drawn and the frame
+// number once it is complete, then 'latest' moves to that frame (release stores),
+// so a reader can check it read a whole frame. With dirty rectangles a buffer is
+// first brought up to the previous frame by copying the regions changed since it
+// was last drawn, from the buffer of the previous frame.
+
+#if defined(IMGUI_IMPL_RASTER_SHARED)
+
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "the shared header is read with 64 bit atomics");
+static_assert(ImGuiImplRasterShared_MaxRects >= MAX_DIRTY_RECTS, "a slot must hold the dirty rectangles of a frame");
+
+static inline std::atomic<uint64_t> &shared_atomic(uint64_t &v) {
+  return *reinterpret_cast<std::atomic<uint64_t>*>(&v);
+}
+
+struct raster_shared_t {
+  ImGuiImplRasterSharedHeader *header = NULL;
+  size_t size = 0;                  // of the mapping
+  std::string name;
+  uint64_t frame = 0;               // last published
+};
+
+static uint8_t *shared_buffer(const raster_shared_t &shared, uint64_t frame)
+{
+    const ImGuiImplRasterSharedHeader &h = *shared.header;
+    return (uint8_t*)shared.header + h.buffer_offset + (frame % h.buffer_count) * h.buffer_stride;
+}
+
+static bool create_shared(raster_shared_t &shared, const char *name, uint32_t buffer_count, const rect_t &viewport, const raster_target_t &target, ImGuiImplRasterFormat format)
+{
+    const uint32_t pitch = uint32_t(viewport.x1) * target.bpp;
+    const size_t header_size = (sizeof(ImGuiImplRasterSharedHeader) + 4095) & ~size_t(4095);
+    const size_t stride = (size_t(pitch) * viewport.y1 + 63) & ~size_t(63);
+    const size_t size = header_size + stride * buffer_count;
+    const int fd = shm_open(name, O_CREAT | O_RDWR | O_TRUNC, 0600);
+    if (fd < 0)
+        return false;
+    void *p = ftruncate(fd, off_t(size)) == 0 ? mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (p == MAP_FAILED) {
+        shm_unlink(name);
+        return false;
+    }
+    ImGuiImplRasterSharedHeader &h = *(ImGuiImplRasterSharedHeader*)p;
+    memset(&h, 0, sizeof(h));
+    h.size = sizeof(h);
+    h.width = uint32_t(viewport.x1);
+    h.height = uint32_t(viewport.y1);
+    h.pitch = pitch;
+    h.format = format;
+    h.buffer_count = buffer_count;
+    h.buffer_offset = header_size;
+    h.buffer_stride = stride;
+    // readers check the magic last
+    std::atomic_thread_fence(std::memory_order_release);
+    h.magic = ImGuiImplRasterShared_Magic;
+    shared.header = &h;
+    shared.size = size;
+    shared.name = name;
+    shared.frame = 0;
+    return true;
+}
+
+static void destroy_shared(raster_shared_t &shared)
+{
+    if (!shared.header)
         return;
-    // barycentric x step
-    const vec3f_t sx = {
-        (v0.y - v1.y) * area, // A01
-        (v1.y - v2.y) * area, // A12
-        (v2.y - v0.y) * area  // A20
-    };
-    // barycentric y step
-    const vec3f_t sy = {
-        (v1.x - v0.x) * area, // B01
-        (v2.x - v1.x) * area, // B12
-        (v0.x - v2.x) * area  // B20
-    };
-    // barycentric start point
-    vec2f_t p = {minx + .5f, miny + .5f};
-    // barycentric value at start point
-    vec3f_t wy = {
-        orient2d(v0, v1, p) * area, // W2 -> A01, B01
-        orient2d(v1, v2, p) * area, // W0 -> A12, B12
-        orient2d(v2, v0, p) * area, // W1 -> A20, B20
-    };
-    // texture start point
-    vec2f_t ty = {
-        (wy.x * t2.x) + (wy.y * t0.x) + (wy.z * t1.x),
-        (wy.x * t2.y) + (wy.y * t0.y) + (wy.z * t1.y),
-    };
-    // texture x step
-    const vec2f_t tsx = {
-        (sx.x * t2.x) + (sx.y * t0.x) + (sx.z * t1.x),
-        (sx.x * t2.y) + (sx.y * t0.y) + (sx.z * t1.y)
-    };
-    // texture y step
-    const vec2f_t tsy = {
-        (sy.x * t2.x) + (sy.y * t0.x) + (sy.z * t1.x),
-        (sy.x * t2.y) + (sy.y * t0.y) + (sy.z * t1.y)
-    };
+    munmap(shared.header, shared.size);
+    shm_unlink(shared.name.c_str());
+    shared.header = NULL;
+}
 
-    uint32_t* pix = g_Info.pixels + miny * g_Info.pitch;
-    // rendering loop
-    for (int32_t py = miny; py < maxy; py++) {
-        vec3f_t wx = wy;
-        vec2f_t tx = ty;
-        for (int32_t px = minx; px < maxx; px++) {
-            // If p is on or inside all edges, render pixel.
-            if (wx.x >= 0 && wx.y >= 0 && wx.z >= 0) {
-              const uint32_t u = uint32_t(tx.x);
-              const uint32_t v = uint32_t(tx.y);
-              const uint32_t index = u + (v * tex.w);
-              const uint32_t rgb = t[index & tmask];
-              if (rgb > 0x7f) {
-                pix[px] = 0xffffff;
-              }
+// Point 'target' at the buffer of the next frame. 'incremental': only the dirty
+// rectangles will be drawn, copy what changed since the buffer was last drawn.
+static void begin_shared_frame(raster_shared_t &shared, raster_target_t &target, bool incremental)
+{
+    ImGuiImplRasterSharedHeader &h = *shared.header;
+    const uint64_t frame = shared.frame + 1;
+    const uint32_t count = h.buffer_count;
+    shared_atomic(h.slots[frame % count].sequence).store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    uint8_t *dst = shared_buffer(shared, frame);
+    target.pixels = dst;
+    if (!incremental || frame == 1)
+        return;
+    const uint8_t *src = shared_buffer(shared, frame - 1);
+    if (frame <= count) {
+        memcpy(dst, src, size_t(h.pitch) * h.height);
+        return;
+    }
+    // frames frame - count + 1 .. frame - 1 changed these
+    for (uint64_t f = frame - count + 1; f < frame; f++) {
+        const ImGuiImplRasterSharedSlot &slot = h.slots[f % count];
+        for (uint32_t i = 0; i < slot.rect_count; i++) {
+            const ImGuiImplRasterRect &r = slot.rects[i];
+            for (int y = r.y; y < r.y + r.h; y++) {
+                const size_t offset = size_t(y) * h.pitch + size_t(r.x) * target.bpp;
+                memcpy(dst + offset, src + offset, size_t(r.w) * target.bpp);
             }
-            // X step
-            wx += sx;
-            tx += tsx;
         }
-        // Y step
-        wy += sy;
-        pix += g_Info.width;
-        ty += tsy;
     }
 }
 
+static void publish_shared_frame(raster_shared_t &shared, const std::vector<ImGuiImplRasterRect> &rects)
+{
+    ImGuiImplRasterSharedHeader &h = *shared.header;
+    const uint64_t frame = shared.frame + 1;
+    ImGuiImplRasterSharedSlot &slot = h.slots[frame % h.buffer_count];
+    IM_ASSERT(rects.size() <= ImGuiImplRasterShared_MaxRects);
+    slot.rect_count = uint32_t(rects.size());
+    if (!rects.empty())
+        memcpy(slot.rects, rects.data(), sizeof(ImGuiImplRasterRect) * slot.rect_count);
+    shared_atomic(slot.sequence).store(frame, std::memory_order_release);
+    shared_atomic(h.latest).store(frame, std::memory_order_release);
+    shared.frame = frame;
+}
+
+#else
+
+struct raster_shared_t {
+  ImGuiImplRasterSharedHeader *header = NULL;
+};
+
+static bool create_shared(raster_shared_t &, const char *, uint32_t, const rect_t &, const raster_target_t &, ImGuiImplRasterFormat) { return false; }
+static void destroy_shared(raster_shared_t &) {}
+static void begin_shared_frame(raster_shared_t &, raster_target_t &, bool) {}
+static void publish_shared_frame(raster_shared_t &, const std::vector<ImGuiImplRasterRect> &) {}
+
+#endif // IMGUI_IMPL_RASTER_SHARED
+
+//-----------------------------------------------------------------------------
+// Contexts
+//-----------------------------------------------------------------------------
+// Everything a renderer instance owns. Contexts share nothing but the (read only)
+// kernel table, so different contexts can render at the same time on different
+// threads. The public functions work on the calling thread's current context.
+
+struct ImGuiImplRasterContext {
+  ImGuiImplRasterinfo info;
+  rect_t viewport;
+  raster_target_t target;
+  std::vector<texture_t> textures;  // slot 0 is the font atlas
+  bool font_texture = false;
+  raster_tiles_t tiles;
+  raster_dirty_t dirty;
+  raster_occlusion_t occlusion;
+  raster_layers_t layers;
+  raster_stream_t stream;
+  raster_shared_t shared;           // header != NULL: rendering into a shared memory ring instead of info.pixels
+  raster_stats_t stats;
+};
+
+static thread_local ImGuiImplRasterContext *g_Context = NULL;
+
+// Point the context at 'pixels', the tiles are rebuilt if the size changed
+static void set_target(ImGuiImplRasterContext &ctx, void *pixels, uint32_t width, uint32_t height, uint32_t pitch)
+{
+    const bool resized = width != ctx.info.width || height != ctx.info.height || ctx.tiles.tiles.empty();
+    ctx.info.pixels = pixels;
+    ctx.info.width = width;
+    ctx.info.height = height;
+    ctx.info.pitch = pitch;
+
+    // Grab the viewport
+    ctx.viewport.x0 = 0;
+    ctx.viewport.y0 = 0;
+    ctx.viewport.x1 = int32_t(width);
+    ctx.viewport.y1 = int32_t(height);
+
+    target_format(ctx.target, ctx.info.format);
+    ctx.target.pixels = (uint8_t*)pixels;
+    ctx.target.pitch = pitch * ctx.target.bpp;
+    ctx.target.fixed = (ctx.info.flags & ImGuiImplRasterFlags_FloatRasterizer) == 0;
+    if (ctx.info.threads && resized) {
+        destroy_tiles(ctx.tiles);
+        create_tiles(ctx.tiles, ctx.viewport, ctx.info.threads);
+    }
+    ctx.dirty.invalidated = true;
+}
+
+ImGuiImplRasterContext* ImGui_ImplRaster_CreateContext(const ImGuiImplRasterinfo *info)
+{
+    ImGuiImplRasterContext *ctx = new ImGuiImplRasterContext();
+    ctx->info = *info;
+    ctx->textures.resize(1);
+    ctx->target.font = &ctx->textures[0];
+    set_target(*ctx, info->pixels, info->width, info->height, info->pitch);
+    return ctx;
+}
+
+void ImGui_ImplRaster_DestroyContext(ImGuiImplRasterContext* ctx)
+{
+    if (ctx == NULL)
+        return;
+    if (g_Context == ctx)
+        g_Context = NULL;
+    end_stream(ctx->stream);
+    destroy_shared(ctx->shared);
+    destroy_tiles(ctx->tiles);
+    delete ctx;
+}
+
+ImGuiImplRasterContext* ImGui_ImplRaster_GetCurrentContext()
+{
+    return g_Context;
+}
+
+void ImGui_ImplRaster_SetCurrentContext(ImGuiImplRasterContext* ctx)
+{
+    g_Context = ctx;
+}
+
+void ImGui_ImplRaster_SetTarget(void* pixels, uint32_t width, uint32_t height, uint32_t pitch)
+{
+    IM_ASSERT(g_Context != NULL && "No current context. Did you call ImGui_ImplRaster_Init() or ImGui_ImplRaster_SetCurrentContext()?");
+    destroy_shared(g_Context->shared);
+    set_target(*g_Context, pixels, width, height, pitch);
+}
+
 // Functions
 bool ImGui_ImplRaster_Init(const ImGuiImplRasterinfo *info)
 {
     // Setup back-end capabilities flags
     ImGuiIO& io = ImGui::GetIO();
     io.BackendRendererName = "imgui_impl_raster";
-    g_Info = *info;
-
-    // Grab the viewport
-    g_viewport.x0 = 0;
-    g_viewport.y0 = 0;
-    g_viewport.x1 = info->width - 1;
-    g_viewport.y1 = info->height - 1;
+    io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;  // We can honor the ImDrawCmd::VtxOffset field, allowing for large meshes.
+    ImGui_ImplRaster_SetCurrentContext(ImGui_ImplRaster_CreateContext(info));
 
     ImGuiStyle& style = ImGui::GetStyle();
     style.AntiAliasedLines = false;
@@ -252,11 +3626,13 @@ bool ImGui_ImplRaster_Init(const ImGuiImplRasterinfo *info)
 void ImGui_ImplRaster_Shutdown()
 {
     ImGui_ImplRaster_DestroyDeviceObjects();
+    ImGui_ImplRaster_DestroyContext(g_Context);
 }
 
 void ImGui_ImplRaster_NewFrame()
 {
-    if (!g_FontTexture)
+    IM_ASSERT(g_Context != NULL && "No current context. Did you call ImGui_ImplRaster_Init() or ImGui_ImplRaster_SetCurrentContext()?");
+    if (!g_Context->font_texture)
     {
         ImGui_ImplRaster_CreateDeviceObjects();
     }
@@ -266,54 +3642,92 @@ static void ImGui_ImplRaster_ResetRenderState(ImDrawData* draw_data, int w, int
 {
 }
 
-static void ImGui_ImplRaster_Draw(const ImDrawVert *vert, const ImDrawIdx *idx, uint32_t count)
+// Fill 'r' with the background colour
+static void ImGui_ImplRaster_Clear(ImGuiImplRasterContext &ctx, const rect_t &r)
+{
+    const int32_t count = r.x1 - r.x0;
+    for (int32_t y = r.y0; y < r.y1; y++)
+    {
+        g_kernels.fill(target_row(ctx.target, r.x0, y, count), count, ctx.info.clear | 0xff000000);
+        target_row_done(ctx.target, r.x0, y, count);
+    }
+}
+
+// Draw a command, 'vert' being the vertices from its VtxOffset. 'key' orders its first
+// primitive for occlusion culling.
+// Returns the number of triangles culled before rasterization: clipped, occluded, transparent or degenerate.
+static uint32_t ImGui_ImplRaster_Draw(ImGuiImplRasterContext &ctx, const ImDrawVert *vert, const ImDrawIdx *idx, uint32_t count, const texture_t &tex, const rect_t &clip, uint64_t key)
 {
-    for (uint32_t i = 0; i < count; i += 3) {
+    const raster_occlusion_t &occ = ctx.occlusion;
+    const raster_target_t &rt = ctx.target;
+    if (ctx.info.threads)
+        return bin_cmd(ctx.tiles, rt, vert, idx, count, tex, clip, occ, key);
+    uint32_t culled = 0;
+    if (occ.keys.empty()) {
+        for (uint32_t i = 0, size; i < count; i += size) {
+            size = prim_size(vert, idx + i, count - i);
+            if (!draw_prim(rt, vert, idx + i, size, tex, clip))
+                culled += size / 3;
+            else if (rt.counts)
+                rt.counts[rt.list].rasterized += size / 3;
+        }
+        return culled;
+    }
+    // what is hidden for the last primitive is hidden for all of them
+    rect_t cmd_clip = clip;
+    if (!occlusion_visible(occ, key + count - 1, cmd_clip))
+        return count / 3;
+    for (uint32_t i = 0, size; i < count; i += size) {
+        size = prim_size(vert, idx + i, count - i);
         const ImDrawVert & v0 = vert[idx[i+0]];
         const ImDrawVert & v1 = vert[idx[i+1]];
         const ImDrawVert & v2 = vert[idx[i+2]];
-
-        if (v0.uv == v1.uv) {
-          draw_triangle(
-            vec2f_t{v0.pos.x, v0.pos.y},
-            vec2f_t{v1.pos.x, v1.pos.y},
-            vec2f_t{v2.pos.x, v2.pos.y},
-            swizzle(v0.col));
-        } else {
-          draw_triangle(
+        rect_t prim_clip = intersect(cmd_clip, triangle_bounds(
             vec2f_t{v0.pos.x, v0.pos.y},
             vec2f_t{v1.pos.x, v1.pos.y},
-            vec2f_t{v2.pos.x, v2.pos.y},
-            vec2f_t{v0.uv.x * g_font.w, v0.uv.y * g_font.h},
-            vec2f_t{v1.uv.x * g_font.w, v1.uv.y * g_font.h},
-            vec2f_t{v2.uv.x * g_font.w, v2.uv.y * g_font.h},
-            g_font);
-        }
+            vec2f_t{v2.pos.x, v2.pos.y}));
+        if (!occlusion_visible(occ, key + i, prim_clip) || !draw_prim(rt, vert, idx + i, size, tex, prim_clip))
+            culled += size / 3;
+        else if (rt.counts)
+            rt.counts[rt.list].rasterized += size / 3;
     }
+    return culled;
 }
 
-void ImGui_ImplRaster_RenderDrawData(ImDrawData* draw_data)
+// Draw everything, restricted to 'bounds'
+static void ImGui_ImplRaster_RenderPass(ImGuiImplRasterContext &ctx, ImDrawData* draw_data, int fb_width, int fb_height, const rect_t &bounds)
 {
-    // Avoid rendering when minimized, scale coordinates for retina displays (screen coordinates != framebuffer coordinates)
-    int fb_width  = (int)(draw_data->DisplaySize.x * draw_data->FramebufferScale.x);
-    int fb_height = (int)(draw_data->DisplaySize.y * draw_data->FramebufferScale.y);
-    if (fb_width == 0 || fb_height == 0) {
-        return;
-    }
-
-    // Setup desired GL state
-    ImGui_ImplRaster_ResetRenderState(draw_data, fb_width, fb_height);
-
     // Will project scissor/clipping rectangles into framebuffer space
     ImVec2 clip_off = draw_data->DisplayPos;         // (0,0) unless using multi-viewports
     ImVec2 clip_scale = draw_data->FramebufferScale; // (1,1) unless using retina display which are often (2,2)
 
     // Render command lists
+    ImGuiImplRasterListStats *stats = ctx.stats.lists.empty() ? NULL : ctx.stats.lists.data();
     for (int n = 0; n < draw_data->CmdListsCount; n++)
     {
         const ImDrawList* cmd_list = draw_data->CmdLists[n];
         const ImDrawVert* vtx_buffer = cmd_list->VtxBuffer.Data;
         const ImDrawIdx* idx_buffer = cmd_list->IdxBuffer.Data;
+        const auto list_start = stats ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+        ctx.target.list = n;
+
+        // Unchanged list, composite its layer
+        if (!ctx.layers.lists.empty() && ctx.layers.lists[n] >= 0)
+        {
+            const raster_layer_t &layer = ctx.layers.layers[ctx.layers.lists[n]];
+            const uint64_t key = (uint64_t(n) << 32) | 0xffffffff;
+            rect_t clip = intersect(bounds, layer.bounds);
+            if (ctx.info.threads)
+                bin_layer(ctx.tiles, layer, clip, ctx.occlusion, key);
+            else if (occlusion_visible(ctx.occlusion, key, clip))
+                draw_layer(ctx.target, layer, clip);
+            if (stats)
+            {
+                stats[n].layer = true;
+                stats[n].milliseconds += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - list_start).count();
+            }
+            continue;
+        }
 
         for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
         {
@@ -322,6 +3736,7 @@ void ImGui_ImplRaster_RenderDrawData(ImDrawData* draw_data)
             {
                 // User callback, registered via ImDrawList::AddCallback()
                 // (ImDrawCallback_ResetRenderState is a special callback value used by the user to request the renderer to reset render state.)
+                // In tiled mode callbacks run while binning, before any of the geometry is rasterized.
                 if (pcmd->UserCallback == ImDrawCallback_ResetRenderState)
                     ImGui_ImplRaster_ResetRenderState(draw_data, fb_width, fb_height);
                 else
@@ -330,19 +3745,223 @@ void ImGui_ImplRaster_RenderDrawData(ImDrawData* draw_data)
             else
             {
                 // Project scissor/clipping rectangles into framebuffer space
-                g_clip.x0 = int32_t((pcmd->ClipRect.x - clip_off.x) * clip_scale.x);
-                g_clip.y0 = int32_t((pcmd->ClipRect.y - clip_off.y) * clip_scale.y);
-                g_clip.x1 = int32_t((pcmd->ClipRect.z - clip_off.x) * clip_scale.x) + 1;
-                g_clip.y1 = int32_t((pcmd->ClipRect.w - clip_off.y) * clip_scale.y) + 1;
-
-                if (g_clip.x0 < fb_width && g_clip.y0 < fb_height && g_clip.x1 >= 0.0f && g_clip.y1 >= 0.0f)
+                const rect_t clip = intersect(project_rect(pcmd->ClipRect, clip_off, clip_scale), bounds);
+                const texture_t *tex = find_texture(ctx.textures, pcmd->TextureId);
+                uint32_t culled = pcmd->ElemCount / 3;
+                if (!clip.empty() && tex)
+                {
+                    const uint64_t key = (uint64_t(n) << 32) | uint64_t(idx_buffer - cmd_list->IdxBuffer.Data);
+                    culled = ImGui_ImplRaster_Draw(ctx, vtx_buffer + pcmd->VtxOffset, idx_buffer, pcmd->ElemCount, *tex, clip, key);
+                }
+                if (stats)
                 {
-                    ImGui_ImplRaster_Draw(vtx_buffer, idx_buffer, pcmd->ElemCount);
+                    stats[n].triangles_submitted += pcmd->ElemCount / 3;
+                    stats[n].triangles_culled += culled;
                 }
             }
             idx_buffer += pcmd->ElemCount;
         }
+        if (stats)
+            stats[n].milliseconds += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - list_start).count();
+    }
+
+    if (ctx.info.threads)
+        flush_tiles(ctx.tiles, ctx.target);
+}
+
+void ImGui_ImplRaster_RenderDrawData(ImDrawData* draw_data)
+{
+    IM_ASSERT(g_Context != NULL && "No current context. Did you call ImGui_ImplRaster_Init() or ImGui_ImplRaster_SetCurrentContext()?");
+    ImGuiImplRasterContext &ctx = *g_Context;
+    raster_dirty_t &dirty = ctx.dirty;
+
+    // Avoid rendering when minimized, scale coordinates for retina displays (screen coordinates != framebuffer coordinates)
+    int fb_width  = (int)(draw_data->DisplaySize.x * draw_data->FramebufferScale.x);
+    int fb_height = (int)(draw_data->DisplaySize.y * draw_data->FramebufferScale.y);
+    dirty.out.clear();
+    if (fb_width == 0 || fb_height == 0) {
+        return;
+    }
+
+    // Setup desired GL state
+    ImGui_ImplRaster_ResetRenderState(draw_data, fb_width, fb_height);
+    ctx.target.font = &ctx.textures[0];     // the slots may have moved since the last frame
+    const bool stats = (ctx.info.flags & ImGuiImplRasterFlags_Stats) != 0;
+    const bool heatmap = (ctx.info.flags & ImGuiImplRasterFlags_OverdrawHeatmap) != 0;
+    ImGuiImplRasterStats &out = ctx.stats.out;
+    if (stats) {
+        begin_stats(ctx.stats, ctx.tiles, ctx.info.threads, draw_data);
+        ctx.target.counts = ctx.stats.counts.data();
+    } else {
+        ctx.stats.lists.clear();
+        ctx.target.counts = NULL;
+    }
+    if (ctx.stats.heatmap && !heatmap)
+        dirty.invalidated = true;       // the target holds the heatmap
+    ctx.stats.heatmap = heatmap;
+    const bool linear = (ctx.info.flags & ImGuiImplRasterFlags_LinearBlending) && ctx.info.format != ImGuiImplRasterFormat_A8;
+    if (ctx.target.kernels != (linear ? &g_kernels_linear : &g_kernels))
+        dirty.invalidated = true;       // drawn with the other blend
+    ctx.target.kernels = linear ? &g_kernels_linear : &g_kernels;
+    if (ctx.info.flags & ImGuiImplRasterFlags_OcclusionCulling)
+        compute_occlusion(ctx.occlusion, ctx.target, ctx.textures, ctx.viewport, draw_data);
+    if ((ctx.info.flags & ImGuiImplRasterFlags_LayerCache) && !heatmap && !linear)
+        update_layers(ctx.layers, ctx.target, ctx.textures, ctx.viewport, draw_data,
+            ctx.info.layer_cache_size ? ctx.info.layer_cache_size : LAYER_CACHE_DEFAULT_SIZE);
+    else
+        ctx.layers.lists.clear();       // layers hide the overdraw of their lists, and are composited in sRGB
+    if (ctx.shared.header)
+        begin_shared_frame(ctx.shared, ctx.target, (ctx.info.flags & ImGuiImplRasterFlags_DirtyRects) != 0);
+    if (stats)
+        out.prepare_ms = stats_phase(ctx.stats);
+
+    if (heatmap)
+    {
+        const raster_target_t target = ctx.target;
+        ctx.target = heat_target(ctx.stats, target, ctx.viewport);
+        dirty.rects.assign(1, ctx.viewport);
+        ImGui_ImplRaster_RenderPass(ctx, draw_data, fb_width, fb_height, ctx.viewport);
+        ctx.target = target;
+        resolve_heat(ctx.stats, ctx.target, ctx.viewport);
+    }
+    else if (ctx.info.flags & ImGuiImplRasterFlags_DirtyRects)
+    {
+        compute_dirty(dirty, ctx.textures, ctx.viewport, draw_data, draw_data->DisplayPos, draw_data->FramebufferScale);
+        for (const rect_t &r : dirty.rects)
+        {
+            ImGui_ImplRaster_Clear(ctx, r);
+            ImGui_ImplRaster_RenderPass(ctx, draw_data, fb_width, fb_height, r);
+        }
+    }
+    else
+    {
+        dirty.rects.assign(1, ctx.viewport);
+        if (ctx.shared.header)
+            ImGui_ImplRaster_Clear(ctx, ctx.viewport);     // ring buffers hold older frames
+        ImGui_ImplRaster_RenderPass(ctx, draw_data, fb_width, fb_height, ctx.viewport);
+    }
+    if (stats)
+        out.raster_ms = stats_phase(ctx.stats);
+
+    for (const rect_t &r : dirty.rects)
+        dirty.out.push_back(ImGuiImplRasterRect{r.x0, r.y0, r.x1 - r.x0, r.y1 - r.y0});
+
+    if (ctx.shared.header)
+        publish_shared_frame(ctx.shared, dirty.out);
+
+    if (ctx.stream.fd >= 0)
+        stream_frame(ctx.stream, ctx.target, ctx.viewport.x1, ctx.viewport.y1, !dirty.rects.empty());
+
+    if (stats) {
+        out.present_ms = stats_phase(ctx.stats);
+        end_stats(ctx.stats, ctx.tiles);
+    }
+}
+
+int ImGui_ImplRaster_GetDirtyRects(const ImGuiImplRasterRect** out_rects)
+{
+    const std::vector<ImGuiImplRasterRect> &out = g_Context->dirty.out;
+    *out_rects = out.empty() ? NULL : out.data();
+    return int(out.size());
+}
+
+void ImGui_ImplRaster_InvalidateFrame()
+{
+    g_Context->dirty.invalidated = true;
+}
+
+const ImGuiImplRasterStats* ImGui_ImplRaster_GetStats()
+{
+    const ImGuiImplRasterContext &ctx = *g_Context;
+    return (ctx.info.flags & ImGuiImplRasterFlags_Stats) ? &ctx.stats.out : NULL;
+}
+
+void ImGui_ImplRaster_ShowMetricsWindow(bool* p_open)
+{
+    ImGui::ShowMetricsWindow(p_open);
+    if (p_open && !*p_open)
+        return;
+
+    // Append to the window ShowMetricsWindow() just submitted
+    ImGuiImplRasterContext &ctx = *g_Context;
+    if (ImGui::Begin("Dear ImGui Metrics", p_open) && ImGui::TreeNode("imgui_impl_raster"))
+    {
+        ImGui::CheckboxFlags("Statistics", (unsigned int*)&ctx.info.flags, ImGuiImplRasterFlags_Stats);
+        ImGui::SameLine();
+        ImGui::CheckboxFlags("Overdraw heatmap", (unsigned int*)&ctx.info.flags, ImGuiImplRasterFlags_OverdrawHeatmap);
+        ImGui::SameLine();
+        ImGui::CheckboxFlags("Linear blending", (unsigned int*)&ctx.info.flags, ImGuiImplRasterFlags_LinearBlending);
+        if (const ImGuiImplRasterStats *stats = ImGui_ImplRaster_GetStats())
+        {
+            const double pixels = double(ctx.viewport.x1) * ctx.viewport.y1;
+            ImGui::Text("%.2f ms prepare, %.2f ms raster, %.2f ms present", stats->prepare_ms, stats->raster_ms, stats->present_ms);
+            ImGui::Text("%u triangles, %u culled, %u rasterized", stats->triangles_submitted, stats->triangles_culled, stats->triangles_rasterized);
+            ImGui::Text("%llu pixels tested, %llu written, overdraw %.2f", (unsigned long long)stats->pixels_tested,
+                (unsigned long long)stats->pixels_written, pixels > 0 ? stats->pixels_written / pixels : 0.0);
+
+            // Most expensive draw lists first
+            std::vector<const ImGuiImplRasterListStats*> lists;
+            for (int n = 0; n < stats->lists_count; n++)
+                lists.push_back(&stats->lists[n]);
+            std::sort(lists.begin(), lists.end(), [](const ImGuiImplRasterListStats *a, const ImGuiImplRasterListStats *b) {
+                return a->milliseconds > b->milliseconds;
+            });
+            ImGui::Columns(6, "imgui_impl_raster_lists");
+            ImGui::Text("Draw list"); ImGui::NextColumn();
+            ImGui::Text("Triangles"); ImGui::NextColumn();
+            ImGui::Text("Culled"); ImGui::NextColumn();
+            ImGui::Text("Written"); ImGui::NextColumn();
+            ImGui::Text("ms"); ImGui::NextColumn();
+            ImGui::Text("Layer"); ImGui::NextColumn();
+            ImGui::Separator();
+            for (const ImGuiImplRasterListStats *list : lists)
+            {
+                ImGui::Text("%s", list->name[0] ? list->name : "(unnamed)"); ImGui::NextColumn();
+                ImGui::Text("%u", list->triangles_submitted); ImGui::NextColumn();
+                ImGui::Text("%u", list->triangles_culled); ImGui::NextColumn();
+                ImGui::Text("%llu", (unsigned long long)list->pixels_written); ImGui::NextColumn();
+                ImGui::Text("%.3f", list->milliseconds); ImGui::NextColumn();
+                ImGui::Text("%s", list->layer ? "yes" : ""); ImGui::NextColumn();
+            }
+            ImGui::Columns(1);
+        }
+        ImGui::TreePop();
     }
+    ImGui::End();
+}
+
+bool ImGui_ImplRaster_BeginStream(int fd, ImGuiImplRasterStreamFormat format, ImGuiImplRasterStreamFlags flags, int fps)
+{
+    ImGuiImplRasterContext &ctx = *g_Context;
+    end_stream(ctx.stream);
+    return begin_stream(ctx.stream, ctx.target, ctx.viewport.x1, ctx.viewport.y1, fd, format, flags, fps);
+}
+
+int ImGui_ImplRaster_EndStream()
+{
+    return end_stream(g_Context->stream);
+}
+
+const ImGuiImplRasterSharedHeader* ImGui_ImplRaster_CreateSharedTarget(const char* name, int buffer_count)
+{
+    ImGuiImplRasterContext &ctx = *g_Context;
+    ImGui_ImplRaster_DestroySharedTarget();
+    if (buffer_count < 2 || buffer_count > ImGuiImplRasterShared_MaxBuffers)
+        return NULL;
+    if (!create_shared(ctx.shared, name, uint32_t(buffer_count), ctx.viewport, ctx.target, ctx.info.format))
+        return NULL;
+    ctx.target.pitch = ctx.shared.header->pitch;
+    ctx.dirty.invalidated = true;
+    return ctx.shared.header;
+}
+
+void ImGui_ImplRaster_DestroySharedTarget()
+{
+    ImGuiImplRasterContext &ctx = *g_Context;
+    if (!ctx.shared.header)
+        return;
+    destroy_shared(ctx.shared);
+    set_target(ctx, ctx.info.pixels, ctx.info.width, ctx.info.height, ctx.info.pitch);
 }
 
 bool ImGui_ImplRaster_CreateFontsTexture()
@@ -358,23 +3977,57 @@ bool ImGui_ImplRaster_CreateFontsTexture()
     // to save on GPU memory.
     io.Fonts->GetTexDataAsAlpha8(&pixels, &width, &height);
 
-    g_font.w = width;
-    g_font.h = height;
-    g_font.tex = (const uint8_t*)pixels;
+    // Register it in the reserved first slot
+    set_texture(g_Context->textures[0], pixels, width, height, 0, TEXTURE_A8, ImGuiImplRasterTextureFlags_AutoFilter);
+    g_Context->font_texture = true;
 
-    // give it a dummy pointer for now
-    io.Fonts->TexID = ImTextureID(-1);
+    // Store our identifier
+    io.Fonts->TexID = (ImTextureID)(intptr_t)1;
     return true;
 }
 
 void ImGui_ImplRaster_DestroyFontsTexture()
 {
-    if (g_FontTexture)
+    if (g_Context && g_Context->font_texture)
     {
-        // delete stuff
+        ImGuiIO& io = ImGui::GetIO();
+        g_Context->textures[0].tex = NULL;
+        io.Fonts->TexID = 0;
+        g_Context->font_texture = false;
     }
 }
 
+ImTextureID ImGui_ImplRaster_CreateTexture(const void* pixels, int width, int height, int pitch, ImGuiImplRasterTextureFormat format, ImGuiImplRasterTextureFlags flags)
+{
+    IM_ASSERT(pixels != NULL && width > 0 && height > 0);
+    IM_ASSERT(format == ImGuiImplRasterTextureFormat_Alpha8 || format == ImGuiImplRasterTextureFormat_RGBA32);
+    std::vector<texture_t> &textures = g_Context->textures;
+    // first free slot, slot 0 is kept for the font atlas
+    size_t slot = 1;
+    while (slot < textures.size() && textures[slot].tex)
+        slot++;
+    if (slot == textures.size())
+        textures.push_back(texture_t());
+    set_texture(textures[slot], pixels, width, height, pitch,
+        format == ImGuiImplRasterTextureFormat_RGBA32 ? TEXTURE_RGBA32 : TEXTURE_A8, flags);
+    return (ImTextureID)(intptr_t)(slot + 1);
+}
+
+void ImGui_ImplRaster_UpdateTexture(ImTextureID tex_id, const void* pixels)
+{
+    texture_t *tex = find_texture(g_Context->textures, tex_id);
+    IM_ASSERT(tex != NULL && pixels != NULL);
+    tex->tex = (const uint8_t*)pixels;
+    tex->version++;
+}
+
+void ImGui_ImplRaster_DestroyTexture(ImTextureID tex_id)
+{
+    texture_t *tex = find_texture(g_Context->textures, tex_id);
+    IM_ASSERT(tex != NULL && tex != &g_Context->textures[0]);
+    tex->tex = NULL;
+}
+
 bool ImGui_ImplRaster_CreateDeviceObjects()
 {
     return ImGui_ImplRaster_CreateFontsTexture();
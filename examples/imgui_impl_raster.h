@@ -8,17 +8,183 @@
 #pragma once
 #include <cstdint>
 
+typedef int ImGuiImplRasterFlags;           // -> enum ImGuiImplRasterFlags_
+typedef int ImGuiImplRasterFormat;          // -> enum ImGuiImplRasterFormat_
+typedef int ImGuiImplRasterTextureFormat;   // -> enum ImGuiImplRasterTextureFormat_
+typedef int ImGuiImplRasterTextureFlags;    // -> enum ImGuiImplRasterTextureFlags_
+typedef int ImGuiImplRasterStreamFormat;    // -> enum ImGuiImplRasterStreamFormat_
+typedef int ImGuiImplRasterStreamFlags;     // -> enum ImGuiImplRasterStreamFlags_
+
+enum ImGuiImplRasterFlags_
+{
+    ImGuiImplRasterFlags_None           = 0,
+    ImGuiImplRasterFlags_DirtyRects     = 1 << 0,   // Only clear and redraw the regions whose draw lists changed since the previous frame. The back-end then owns clearing the target (with 'clear'), query the regions with ImGui_ImplRaster_GetDirtyRects().
+    ImGuiImplRasterFlags_FloatRasterizer = 1 << 1,   // Use the older floating point triangle core instead of the 28.4 fixed point one with the top-left fill rule. Shared edges of translucent triangles may then be drawn twice.
+    ImGuiImplRasterFlags_OcclusionCulling = 1 << 2,  // Skip geometry that a later opaque rectangle covers (per 64x64 tile), e.g. windows behind other windows. Only pays off when WindowBg (or other large fills) are opaque.
+    ImGuiImplRasterFlags_LayerCache     = 1 << 3,   // Keep the pixels of draw lists that stopped changing (see ImGuiImplRasterinfo::layer_cache_size) and composite them instead of rasterizing them again. Colours may differ from drawing directly by a rounding step or two.
+    ImGuiImplRasterFlags_Stats          = 1 << 4,   // Count triangles and pixels per draw list and time each frame, see ImGui_ImplRaster_GetStats(). Costs a little on every triangle row.
+    ImGuiImplRasterFlags_OverdrawHeatmap = 1 << 5,  // Draw how many times each pixel is written instead of the UI: black, blue, green, yellow, orange, red, then white for 6 writes or more. Always redraws the whole target and bypasses the layer cache.
+    ImGuiImplRasterFlags_LinearBlending = 1 << 6,   // Blend in linear light: the colours and the target are taken as sRGB and converted through tables for each blend, so anti-aliased edges and translucent fills keep their perceived weight. Frames take 1.5 to 2.5 times as long to draw (see example_null_raster --linear). Bypasses the layer cache, ignored by A8 targets.
+};
+
+// Pixel format of the target. Anything but BGRA32 is drawn through a small staging row per thread, so only the pixels
+// actually drawn are converted (there is no conversion pass over the frame).
+enum ImGuiImplRasterFormat_
+{
+    ImGuiImplRasterFormat_BGRA32,   // uint32_t 0xXXRRGGBB per pixel (B, G, R, X in memory on little endian), the default
+    ImGuiImplRasterFormat_RGBA32,   // R, G, B, A bytes in memory, alpha is written as 255
+    ImGuiImplRasterFormat_RGB565,   // uint16_t per pixel, red in the top 5 bits, with 4x4 ordered dithering
+    ImGuiImplRasterFormat_A8,       // 1 byte per pixel: the coverage (alpha) of everything drawn, e.g. a mask to composite the UI with
+};
+
+enum ImGuiImplRasterTextureFormat_
+{
+    ImGuiImplRasterTextureFormat_Alpha8,    // 1 byte per texel, white with that alpha (like the font atlas)
+    ImGuiImplRasterTextureFormat_RGBA32,    // 4 bytes per texel, R, G, B, A in memory (like GetTexDataAsRGBA32())
+};
+
+enum ImGuiImplRasterTextureFlags_
+{
+    ImGuiImplRasterTextureFlags_None        = 0,
+    ImGuiImplRasterTextureFlags_Bilinear    = 1 << 0,   // Bilinear filtering instead of nearest texel
+    ImGuiImplRasterTextureFlags_Wrap        = 1 << 1,   // Repeat outside [0, 1] instead of clamping to the edge texels
+    ImGuiImplRasterTextureFlags_AutoFilter  = 1 << 2,   // Bilinear filtering only where the texture is drawn scaled or rotated, nearest texel where one texel maps to one pixel (the font atlas uses this)
+};
+
+enum ImGuiImplRasterStreamFormat_
+{
+    ImGuiImplRasterStreamFormat_RawRGBA,    // width * height * 4 bytes per frame, R, G, B, A (255), no headers
+    ImGuiImplRasterStreamFormat_Y4M,        // YUV4MPEG2, 4:2:0 full range BT.601 (e.g. "ffmpeg -i - out.mp4")
+    ImGuiImplRasterStreamFormat_PPM,        // binary PPM (P6) images back to back (e.g. "ffmpeg -f image2pipe -i - out.mp4")
+};
+
+enum ImGuiImplRasterStreamFlags_
+{
+    ImGuiImplRasterStreamFlags_None         = 0,
+    ImGuiImplRasterStreamFlags_ChangedOnly  = 1 << 0,   // Skip frames identical to the previous one. Each PPM image has a "# t=<microseconds>" comment, Y4M frames a "Xt=<microseconds>" parameter.
+};
+
 struct ImGuiImplRasterinfo {
-  uint32_t *pixels;
+  void *pixels;       // first pixel, in 'format'
   uint32_t width, height;
-  uint32_t pitch;
+  uint32_t pitch;     // pixels (not bytes) from one row to the next
+  uint32_t threads;   // 0: rasterize serially on the calling thread, N: bin into tiles and rasterize them on N threads (including the caller)
+  ImGuiImplRasterFlags flags;
+  uint32_t clear;     // 0xRRGGBB background, used by ImGuiImplRasterFlags_DirtyRects (A8 targets take its brightest channel)
+  ImGuiImplRasterFormat format;
+  uint32_t layer_cache_size;    // bytes kept by ImGuiImplRasterFlags_LayerCache (4 per pixel of a cached list), 0: 64 MB
+};
+
+// A region of the target, in pixels (same layout as SDL_Rect)
+struct ImGuiImplRasterRect {
+  int x, y, w, h;
+};
+
+// Layout of a shared memory target (see ImGui_ImplRaster_CreateSharedTarget()), for the reading process.
+// Frame N (from 1) is in buffer N % buffer_count at 'buffer_offset + (N % buffer_count) * buffer_stride' bytes from the header.
+// To read the latest frame: load 'latest' (acquire), copy its buffer, then (after an acquire fence) check that the slot of the
+// buffer still holds that sequence number, otherwise the buffer was reused meanwhile and the copy must be retried.
+enum
+{
+    ImGuiImplRasterShared_Magic         = 0x52534d49,   // "IMSR"
+    ImGuiImplRasterShared_MaxBuffers    = 8,
+    ImGuiImplRasterShared_MaxRects      = 16,
 };
 
+struct ImGuiImplRasterSharedSlot {
+  uint64_t sequence;          // frame in the buffer, 0 while it is drawn
+  uint32_t rect_count, pad;
+  ImGuiImplRasterRect rects[ImGuiImplRasterShared_MaxRects];  // regions that differ from the previous frame
+};
+
+struct ImGuiImplRasterSharedHeader {
+  uint32_t magic;             // ImGuiImplRasterShared_Magic once the rest is valid
+  uint32_t size;              // sizeof(ImGuiImplRasterSharedHeader)
+  uint32_t width, height;
+  uint32_t pitch;             // bytes (not pixels) from one row to the next
+  ImGuiImplRasterFormat format;
+  uint32_t buffer_count, pad;
+  uint64_t buffer_offset, buffer_stride;
+  uint64_t latest;            // last complete frame, 0 before the first one
+  ImGuiImplRasterSharedSlot slots[ImGuiImplRasterShared_MaxBuffers];  // per buffer
+};
+
+// Work done for one ImDrawList of the last frame, see ImGuiImplRasterFlags_Stats.
+// Every submitted triangle is either culled or rasterized, once, with or without threads.
+struct ImGuiImplRasterListStats {
+  const ImDrawList* list;             // as in the draw data, only for identification after that frame
+  char name[32];                      // ImDrawList::_OwnerName (the window), truncated
+  uint32_t triangles_submitted;       // in its draw commands, rectangles count as 2
+  uint32_t triangles_culled;          // left out before rasterization: clipped, occluded, transparent or degenerate
+  uint32_t triangles_rasterized;      // set up and scanned
+  uint64_t pixels_tested;             // handed to the row kernels
+  uint64_t pixels_written;            // covered (exact with the fixed point core)
+  float milliseconds;                 // drawing it, or binning it into tiles with threads
+  bool layer;                         // composited from the layer cache
+};
+
+struct ImGuiImplRasterStats {
+  uint32_t triangles_submitted, triangles_culled, triangles_rasterized;   // sums of the lists
+  uint64_t pixels_tested, pixels_written;
+  float prepare_ms;                   // occlusion culling, layer cache and dirty rectangles
+  float raster_ms;                    // clearing and drawing (with threads, until the last tile is done)
+  float present_ms;                   // heatmap, shared memory target and streaming
+  int lists_count;
+  const ImGuiImplRasterListStats* lists;
+};
+
+struct ImGuiImplRasterContext;      // Opaque renderer instance: target, textures, worker threads, dirty rectangles
+
+// Init() creates a context and makes it current, Shutdown() destroys the current context.
 IMGUI_IMPL_API bool     ImGui_ImplRaster_Init(const ImGuiImplRasterinfo *info);
 IMGUI_IMPL_API void     ImGui_ImplRaster_Shutdown();
 IMGUI_IMPL_API void     ImGui_ImplRaster_NewFrame();
 IMGUI_IMPL_API void     ImGui_ImplRaster_RenderDrawData(ImDrawData* draw_data);
 
+// Explicit contexts, e.g. to render several ImGui contexts into different targets on different threads at the same time.
+// Every other function works on the current context, which is per thread. Contexts share nothing, but ImGui itself must then use
+// a thread local current context too (see GImGui in imgui.cpp). Unlike Init(), CreateContext() leaves the ImGui style alone.
+IMGUI_IMPL_API ImGuiImplRasterContext* ImGui_ImplRaster_CreateContext(const ImGuiImplRasterinfo *info);
+IMGUI_IMPL_API void     ImGui_ImplRaster_DestroyContext(ImGuiImplRasterContext* ctx);
+IMGUI_IMPL_API ImGuiImplRasterContext* ImGui_ImplRaster_GetCurrentContext();
+IMGUI_IMPL_API void     ImGui_ImplRaster_SetCurrentContext(ImGuiImplRasterContext* ctx);
+// Render into another buffer from now on (e.g. the back buffer of a swap chain, or after a resize). Redraws everything on the next frame.
+// The format stays the one given at creation.
+IMGUI_IMPL_API void     ImGui_ImplRaster_SetTarget(void* pixels, uint32_t width, uint32_t height, uint32_t pitch);
+
+// Regions of the target written by the last ImGui_ImplRaster_RenderDrawData() call, e.g. for SDL_UpdateWindowSurfaceRects().
+// Without ImGuiImplRasterFlags_DirtyRects this is the whole target.
+IMGUI_IMPL_API int      ImGui_ImplRaster_GetDirtyRects(const ImGuiImplRasterRect** out_rects);
+// Redraw everything on the next frame, e.g. after the application drew into the target itself.
+IMGUI_IMPL_API void     ImGui_ImplRaster_InvalidateFrame();
+
+// Write every frame rendered from now on to 'fd' (a file, pipe or socket, left open), from a writer thread so rendering never waits
+// for I/O: a frame that arrives while the writer is still busy replaces the one waiting and the latter is dropped. Frames of another
+// size than the target when the stream began are dropped too. 'fps' only goes in the Y4M header. EndStream() writes the frame still
+// waiting and returns the number of frames dropped.
+IMGUI_IMPL_API bool     ImGui_ImplRaster_BeginStream(int fd, ImGuiImplRasterStreamFormat format, ImGuiImplRasterStreamFlags flags = 0, int fps = 60);
+IMGUI_IMPL_API int      ImGui_ImplRaster_EndStream();
+
+// Render into a POSIX shared memory object 'name' (e.g. "/imgui", see shm_open()) holding a header and a ring of 'buffer_count'
+// (2 to 8) framebuffers of the target size and format, so another process can read the frames without copies or locks (see
+// ImGuiImplRasterSharedHeader). The back-end then owns clearing (with ImGuiImplRasterinfo::clear) and info.pixels is left alone until
+// DestroySharedTarget() (or SetTarget()) unlinks the object. Returns NULL on failure and on platforms without POSIX shared memory.
+IMGUI_IMPL_API const ImGuiImplRasterSharedHeader* ImGui_ImplRaster_CreateSharedTarget(const char* name, int buffer_count = 3);
+IMGUI_IMPL_API void     ImGui_ImplRaster_DestroySharedTarget();
+
+// Statistics of the last ImGui_ImplRaster_RenderDrawData() call, NULL without ImGuiImplRasterFlags_Stats. Valid until the next call.
+IMGUI_IMPL_API const ImGuiImplRasterStats* ImGui_ImplRaster_GetStats();
+// ImGui::ShowMetricsWindow() with a section about this renderer: the statistics, the most expensive draw lists and toggles for
+// ImGuiImplRasterFlags_Stats, ImGuiImplRasterFlags_OverdrawHeatmap and ImGuiImplRasterFlags_LinearBlending.
+IMGUI_IMPL_API void     ImGui_ImplRaster_ShowMetricsWindow(bool* p_open = NULL);
+
+// Register a CPU image for use with ImGui::Image()/ImDrawList::AddImage(). The pixels are referenced, not copied: keep them alive
+// until ImGui_ImplRaster_DestroyTexture(). 'pitch' is in bytes, 0 for tightly packed rows.
+// After changing the pixels call ImGui_ImplRaster_UpdateTexture() (with the same or a new pointer) so dirty rectangles see it.
+IMGUI_IMPL_API ImTextureID ImGui_ImplRaster_CreateTexture(const void* pixels, int width, int height, int pitch, ImGuiImplRasterTextureFormat format, ImGuiImplRasterTextureFlags flags = 0);
+IMGUI_IMPL_API void     ImGui_ImplRaster_UpdateTexture(ImTextureID tex_id, const void* pixels);
+IMGUI_IMPL_API void     ImGui_ImplRaster_DestroyTexture(ImTextureID tex_id);
+
 // Called by Init/NewFrame/Shutdown
 IMGUI_IMPL_API bool     ImGui_ImplRaster_CreateFontsTexture();
 IMGUI_IMPL_API void     ImGui_ImplRaster_DestroyFontsTexture();
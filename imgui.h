@@ -30,7 +30,7 @@ Index of this file:
 // Misc data structures (ImGuiInputTextCallbackData, ImGuiSizeCallbackData, ImGuiPayload)
 // Obsolete functions
 // Helpers (ImGuiOnceUponAFrame, ImGuiTextFilter, ImGuiTextBuffer, ImGuiStorage, ImGuiListClipper, ImColor)
-// Draw List API (ImDrawCallback, ImDrawCmd, ImDrawIdx, ImDrawVert, ImDrawChannel, ImDrawListSplitter, ImDrawListFlags, ImDrawList, ImDrawData)
+// Draw List API (ImDrawCallback, ImDrawCmd, ImDrawIdx, ImDrawVert, ImDrawChannel, ImDrawListSplitter, ImDrawListCache, ImDrawListFlags, ImDrawList, ImDrawData)
 // Font API (ImFontConfig, ImFontGlyph, ImFontGlyphRangesBuilder, ImFontAtlasFlags, ImFontAtlas, ImFont)
 
 */
@@ -116,6 +116,8 @@ struct ImDrawChannel;               // Temporary storage to output draw commands
 struct ImDrawCmd;                   // A single draw command within a parent ImDrawList (generally maps to 1 GPU draw call, unless it is a callback)
 struct ImDrawData;                  // All draw command lists required to render the frame + pos/size coordinates to use for the projection matrix.
 struct ImDrawList;                  // A single draw command list (generally one per window, conceptually you may see this as a dynamic "mesh" builder)
+struct ImDrawListCache;             // Helper to record sections of a draw list once and replay them in later frames while their content is unchanged.
+struct ImDrawListRecording;         // A section of a draw list recorded by ImDrawListCache
 struct ImDrawListSharedData;        // Data shared among multiple draw lists (typically owned by parent ImGui context, but you may create one yourself)
 struct ImDrawListSplitter;          // Helper to split a draw list into different layers which can be drawn into out of order, then flattened back.
 struct ImDrawVert;                  // A single vertex (pos + uv + col = 20 bytes by default. Override layout with IMGUI_OVERRIDE_DRAWVERT_STRUCT_LAYOUT)
@@ -1371,6 +1373,7 @@ struct ImGuiStyle
     float       MouseCursorScale;           // Scale software rendered mouse cursor (when io.MouseDrawCursor is enabled). May be removed later.
     bool        AntiAliasedLines;           // Enable anti-aliasing on lines/borders. Disable if you are really tight on CPU/GPU.
     bool        AntiAliasedFill;            // Enable anti-aliasing on filled shapes (rounded rectangles, circles, etc.)
+    bool        DecimateLines;              // Reduce long polylines and PlotLines() to what can show at the current scale (min/max per pixel column). Cost then follows the screen width instead of the data size.
     float       CurveTessellationTol;       // Tessellation tolerance when using PathBezierCurveTo() without a specific number of segments. Decrease for highly tessellated curves (higher quality, more polygons), increase to reduce quality.
     float       CircleSegmentMaxError;      // Maximum error (in pixels) allowed when using AddCircle()/AddCircleFilled() or drawing rounded corner rectangles with no explicit segment count specified. Decrease for higher quality but more geometry.
     ImVec4      Colors[ImGuiCol_COUNT];
@@ -1809,7 +1812,7 @@ struct ImColor
 };
 
 //-----------------------------------------------------------------------------
-// Draw List API (ImDrawCmd, ImDrawIdx, ImDrawVert, ImDrawChannel, ImDrawListSplitter, ImDrawListFlags, ImDrawList, ImDrawData)
+// Draw List API (ImDrawCmd, ImDrawIdx, ImDrawVert, ImDrawChannel, ImDrawListSplitter, ImDrawListCache, ImDrawListFlags, ImDrawList, ImDrawData)
 // Hold a series of drawing commands. The user provides a renderer for ImDrawData which essentially contains an array of ImDrawList.
 //-----------------------------------------------------------------------------
 
@@ -1893,6 +1896,40 @@ struct ImDrawListSplitter
     IMGUI_API void              SetCurrentChannel(ImDrawList* draw_list, int channel_idx);
 };
 
+// For use by ImDrawListCache.
+struct ImDrawListRecording
+{
+    ImU32                       _Hash;       // Content hash given when recording
+    ImVec2                      _Origin;     // Origin given when recording
+    ImVector<ImDrawCmd>         _CmdBuffer;  // VtxOffset and IdxOffset relative to the recording, indices relative to VtxOffset
+    ImVector<ImDrawIdx>         _IdxBuffer;
+    ImVector<ImDrawVert>        _VtxBuffer;
+};
+
+// Record a section of a draw list once, then replay it in later frames instead of submitting the same shapes again.
+// Recordings are looked up by a user key and only replayed while the hash of their content given by the user matches.
+// Replay copies the vertices, indices and commands, fixing up their offsets, and translates the vertices and clipping
+// rectangles by the difference between its 'origin' and the recorded one. Clipping rectangles are also clipped by the current one.
+//   if (!cache.Replay(draw_list, id, hash, pos)) { cache.BeginRecord(draw_list, id, hash, pos); [...draw...]; cache.EndRecord(draw_list); }
+// Vertices keep the colors and texture coordinates they were recorded with: clear the cache if the style or font atlas change.
+// Don't switch channels (ImDrawListSplitter) between BeginRecord() and EndRecord().
+struct ImDrawListCache
+{
+    ImGuiStorage                    _Map;           // Key -> index of its recording in _Recordings, plus one
+    ImVector<ImDrawListRecording>   _Recordings;    // Never shrunk so their allocations are reused
+    int                             _Current;       // Recording in progress (-1 if none)
+    int                             _CmdStart;      // Size of the draw list buffers when it started
+    int                             _IdxStart;
+    int                             _VtxStart;
+
+    inline ImDrawListCache()  { _Current = -1; _CmdStart = _IdxStart = _VtxStart = 0; }
+    inline ~ImDrawListCache() { ClearFreeMemory(); }
+    IMGUI_API void              ClearFreeMemory();
+    IMGUI_API bool              Replay(ImDrawList* draw_list, ImGuiID key, ImU32 hash, const ImVec2& origin = ImVec2(0, 0));    // Return false if there is no recording for 'key' and 'hash'
+    IMGUI_API void              BeginRecord(ImDrawList* draw_list, ImGuiID key, ImU32 hash, const ImVec2& origin = ImVec2(0, 0));
+    IMGUI_API void              EndRecord(ImDrawList* draw_list);
+};
+
 enum ImDrawCornerFlags_
 {
     ImDrawCornerFlags_None      = 0,
@@ -1912,7 +1949,8 @@ enum ImDrawListFlags_
     ImDrawListFlags_None             = 0,
     ImDrawListFlags_AntiAliasedLines = 1 << 0,  // Lines are anti-aliased (*2 the number of triangles for 1.0f wide line, otherwise *3 the number of triangles)
     ImDrawListFlags_AntiAliasedFill  = 1 << 1,  // Filled shapes have anti-aliased edges (*2 the number of vertices)
-    ImDrawListFlags_AllowVtxOffset   = 1 << 2   // Can emit 'VtxOffset > 0' to allow large meshes. Set when 'ImGuiBackendFlags_RendererHasVtxOffset' is enabled.
+    ImDrawListFlags_AllowVtxOffset   = 1 << 2,  // Can emit 'VtxOffset > 0' to allow large meshes. Set when 'ImGuiBackendFlags_RendererHasVtxOffset' is enabled.
+    ImDrawListFlags_DecimateLines    = 1 << 3   // Long polylines keep at most 4 points per pixel column (first, last, lowest, highest) before tessellation. Plots sample every value.
 };
 
 // Draw command list
@@ -1977,6 +2015,14 @@ struct ImDrawList
     IMGUI_API void  AddConvexPolyFilled(const ImVec2* points, int num_points, ImU32 col); // Note: Anti-aliased filling requires points to be in clockwise order.
     IMGUI_API void  AddBezierCurve(const ImVec2& p1, const ImVec2& p2, const ImVec2& p3, const ImVec2& p4, ImU32 col, float thickness, int num_segments = 0);
 
+    // Batched primitives
+    // - Same output as calling AddRectFilled() (without rounding), AddLine() or AddCircleFilled() once per element, but reserving
+    //   the vertices and indices once per batch. Use when drawing thousands of cells, markers or ticks.
+    // - The arguments are parallel arrays of 'count' elements (structure of arrays). Elements with a transparent color are skipped.
+    IMGUI_API void  AddRectsFilled(const ImVec2* p_min, const ImVec2* p_max, const ImU32* col, int count);
+    IMGUI_API void  AddLines(const ImVec2* p1, const ImVec2* p2, const ImU32* col, int count, float thickness = 1.0f);
+    IMGUI_API void  AddCirclesFilled(const ImVec2* center, const float* radius, const ImU32* col, int count, int num_segments = 12);
+
     // Image primitives
     // - Read FAQ to understand what ImTextureID is.
     // - "p_min" and "p_max" represent the upper-left and lower-right corners of the rectangle.
@@ -9,6 +9,7 @@ Index of this file:
 // [SECTION] Style functions
 // [SECTION] ImDrawList
 // [SECTION] ImDrawListSplitter
+// [SECTION] ImDrawListCache
 // [SECTION] ImDrawData
 // [SECTION] Helpers ShadeVertsXXX functions
 // [SECTION] ImFontConfig
@@ -48,6 +49,12 @@ Index of this file:
 #endif
 #endif
 
+// SSE2 intrinsics for the anti-aliased polyline tessellation (x86-64, or x86 with SSE2 code generation), unless IMGUI_DISABLE_SSE
+#if !defined(IMGUI_DISABLE_SSE) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define IMGUI_ENABLE_SSE
+#include <emmintrin.h>
+#endif
+
 // Visual Studio warnings
 #ifdef _MSC_VER
 #pragma warning (disable: 4127) // condition expression is constant
@@ -620,6 +627,201 @@ void ImDrawList::PrimQuadUV(const ImVec2& a, const ImVec2& b, const ImVec2& c, c
 #define IM_NORMALIZE2F_OVER_ZERO(VX,VY)     do { float d2 = VX*VX + VY*VY; if (d2 > 0.0f) { float inv_len = 1.0f / ImSqrt(d2); VX *= inv_len; VY *= inv_len; } } while (0)
 #define IM_FIXNORMAL2F(VX,VY)               do { float d2 = VX*VX + VY*VY; if (d2 < 0.5f) d2 = 0.5f; float inv_lensq = 1.0f / d2; VX *= inv_lensq; VY *= inv_lensq; } while (0)
 
+// Stages of the anti-aliased AddPolyline() tessellation. With IMGUI_ENABLE_SSE they process several segments or points at once
+// and give exactly the same vertices as the scalar code (IEEE square roots and divisions, no reciprocal approximations).
+
+// Normal (dy, -dx) of the segment p1 -> p2, normalized as IM_NORMALIZE2F_OVER_ZERO()
+static inline void PolylineNormal(const ImVec2& p1, const ImVec2& p2, ImVec2& out)
+{
+    float dx = p2.x - p1.x;
+    float dy = p2.y - p1.y;
+    IM_NORMALIZE2F_OVER_ZERO(dx, dy);
+    out.x = dy;
+    out.y = -dx;
+}
+
+// Normals of the segments points[i] -> points[i+1] for i in [0, count)
+static inline void PolylineNormals(const ImVec2* points, int count, ImVec2* out)
+{
+    int i = 0;
+#ifdef IMGUI_ENABLE_SSE
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    for (; i + 4 <= count; i += 4)
+    {
+        // x and y of 4 segments in separate registers
+        const __m128 a01 = _mm_loadu_ps(&points[i].x), a23 = _mm_loadu_ps(&points[i+2].x);
+        const __m128 b01 = _mm_loadu_ps(&points[i+1].x), b23 = _mm_loadu_ps(&points[i+3].x);
+        __m128 dx = _mm_sub_ps(_mm_shuffle_ps(b01, b23, _MM_SHUFFLE(2,0,2,0)), _mm_shuffle_ps(a01, a23, _MM_SHUFFLE(2,0,2,0)));
+        __m128 dy = _mm_sub_ps(_mm_shuffle_ps(b01, b23, _MM_SHUFFLE(3,1,3,1)), _mm_shuffle_ps(a01, a23, _MM_SHUFFLE(3,1,3,1)));
+        const __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        const __m128 inv_len = _mm_div_ps(one, _mm_sqrt_ps(d2));
+        const __m128 non_zero = _mm_cmpgt_ps(d2, zero);
+        dx = _mm_or_ps(_mm_and_ps(non_zero, _mm_mul_ps(dx, inv_len)), _mm_andnot_ps(non_zero, dx));
+        dy = _mm_or_ps(_mm_and_ps(non_zero, _mm_mul_ps(dy, inv_len)), _mm_andnot_ps(non_zero, dy));
+        const __m128 ny = _mm_xor_ps(dx, sign);
+        _mm_storeu_ps(&out[i].x, _mm_unpacklo_ps(dy, ny));
+        _mm_storeu_ps(&out[i+2].x, _mm_unpackhi_ps(dy, ny));
+    }
+#endif
+    for (; i < count; i++)
+        PolylineNormal(points[i], points[i+1], out[i]);
+}
+
+// Offset of the joint between segments of normals n1 and n2: their average, fixed up as IM_FIXNORMAL2F()
+static inline void PolylineMiter(const ImVec2& n1, const ImVec2& n2, ImVec2& out)
+{
+    float dm_x = (n1.x + n2.x) * 0.5f;
+    float dm_y = (n1.y + n2.y) * 0.5f;
+    IM_FIXNORMAL2F(dm_x, dm_y);
+    out.x = dm_x;
+    out.y = dm_y;
+}
+
+// Offsets of the points [1, count), between the segments i-1 and i
+static inline void PolylineMiters(const ImVec2* normals, int count, ImVec2* out)
+{
+    int i = 1;
+#ifdef IMGUI_ENABLE_SSE
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (; i + 2 <= count; i += 2)
+    {
+        // 2 points as (x, y, x, y), the squared length summed across each pair
+        const __m128 dm = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&normals[i-1].x), _mm_loadu_ps(&normals[i].x)), half);
+        const __m128 sq = _mm_mul_ps(dm, dm);
+        const __m128 d2 = _mm_max_ps(half, _mm_add_ps(sq, _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(2,3,0,1))));  // NaN stays NaN, as 'if (d2 < 0.5f)'
+        _mm_storeu_ps(&out[i].x, _mm_mul_ps(dm, _mm_div_ps(one, d2)));
+    }
+#endif
+    for (; i < count; i++)
+        PolylineMiter(normals[i-1], normals[i], out[i]);
+}
+
+// Vertexes of the points, offset by 'offsets' scaled by 'outer' (and 'inner' for thick lines):
+// thin lines (point, outer, outer) and thick lines (outer, inner, inner, outer), the outer ones transparent.
+static inline void PolylineVertices(ImDrawVert* vtx, const ImVec2* points, const ImVec2* offsets, int count, bool thick_line, float outer, float inner, const ImVec2& uv, ImU32 col, ImU32 col_trans)
+{
+    int i = 0;
+#if defined(IMGUI_ENABLE_SSE) && !defined(IMGUI_OVERRIDE_DRAWVERT_STRUCT_LAYOUT)
+    // 2 points at once, each vertex written as one (pos, uv) store followed by its color
+    const __m128 uv2 = _mm_setr_ps(uv.x, uv.y, uv.x, uv.y);
+    const __m128 scale_outer = _mm_set1_ps(outer);
+    const __m128 scale_inner = _mm_set1_ps(inner);
+    const int stride = thick_line ? 4 : 3;
+    for (; i + 2 <= count; i += 2, vtx += stride * 2)
+    {
+        const __m128 p = _mm_loadu_ps(&points[i].x);
+        const __m128 o = _mm_loadu_ps(&offsets[i].x);
+        const __m128 o_outer = _mm_mul_ps(o, scale_outer);
+        ImDrawVert* v = vtx;
+        for (int k = 0; k < 2; k++, v += stride)
+        {
+            #define IM_POLYLINE_STORE_VTX(N, POS, COL) do { _mm_storeu_ps(&v[N].pos.x, k ? _mm_movehl_ps(uv2, POS) : _mm_movelh_ps(POS, uv2)); v[N].col = COL; } while (0)
+            if (!thick_line)
+            {
+                IM_POLYLINE_STORE_VTX(0, p, col);
+                IM_POLYLINE_STORE_VTX(1, _mm_add_ps(p, o_outer), col_trans);
+                IM_POLYLINE_STORE_VTX(2, _mm_sub_ps(p, o_outer), col_trans);
+            }
+            else
+            {
+                const __m128 o_inner = _mm_mul_ps(o, scale_inner);
+                IM_POLYLINE_STORE_VTX(0, _mm_add_ps(p, o_outer), col_trans);
+                IM_POLYLINE_STORE_VTX(1, _mm_add_ps(p, o_inner), col);
+                IM_POLYLINE_STORE_VTX(2, _mm_sub_ps(p, o_inner), col);
+                IM_POLYLINE_STORE_VTX(3, _mm_sub_ps(p, o_outer), col_trans);
+            }
+            #undef IM_POLYLINE_STORE_VTX
+        }
+    }
+#endif
+    for (; i < count; i++)
+    {
+        const ImVec2& p = points[i];
+        const ImVec2& o = offsets[i];
+        if (!thick_line)
+        {
+            vtx[0].pos = p;                                                 vtx[0].uv = uv; vtx[0].col = col;
+            vtx[1].pos.x = p.x + o.x * outer; vtx[1].pos.y = p.y + o.y * outer; vtx[1].uv = uv; vtx[1].col = col_trans;
+            vtx[2].pos.x = p.x - o.x * outer; vtx[2].pos.y = p.y - o.y * outer; vtx[2].uv = uv; vtx[2].col = col_trans;
+            vtx += 3;
+        }
+        else
+        {
+            vtx[0].pos.x = p.x + o.x * outer; vtx[0].pos.y = p.y + o.y * outer; vtx[0].uv = uv; vtx[0].col = col_trans;
+            vtx[1].pos.x = p.x + o.x * inner; vtx[1].pos.y = p.y + o.y * inner; vtx[1].uv = uv; vtx[1].col = col;
+            vtx[2].pos.x = p.x - o.x * inner; vtx[2].pos.y = p.y - o.y * inner; vtx[2].uv = uv; vtx[2].col = col;
+            vtx[3].pos.x = p.x - o.x * outer; vtx[3].pos.y = p.y - o.y * outer; vtx[3].uv = uv; vtx[3].col = col_trans;
+            vtx += 4;
+        }
+    }
+}
+
+// Indexes of a segment relative to the first vertex of its first point, the vertexes of its second point following.
+// Padded to whole SSE registers: the padding written for a segment is overwritten by the next one.
+static const ImDrawIdx PolylineIdxThin[16] = { 3,0,2, 2,5,3, 4,1,0, 0,3,4 };
+static const ImDrawIdx PolylineIdxThick[24] = { 5,1,2, 2,6,5, 5,1,0, 0,4,5, 6,2,3, 3,7,6 };
+
+// Indexes of 'segments' segments whose first vertexes start at 'base', 'vtx_stride' apart. A segment must follow them.
+static inline void PolylineIndices(ImDrawIdx* dst, const ImDrawIdx* pattern, int idx_stride, int segments, unsigned int base, int vtx_stride)
+{
+    int s = 0;
+#ifdef IMGUI_ENABLE_SSE
+    const int lanes = 16 / (int)sizeof(ImDrawIdx);
+    const int regs = (idx_stride + lanes - 1) / lanes;
+    __m128i pat[24 * sizeof(ImDrawIdx) / 16];
+    for (int r = 0; r < regs; r++)
+        pat[r] = _mm_loadu_si128((const __m128i*)(pattern + r * lanes));
+    __m128i b = sizeof(ImDrawIdx) == 2 ? _mm_set1_epi16((short)base) : _mm_set1_epi32((int)base);
+    const __m128i step = sizeof(ImDrawIdx) == 2 ? _mm_set1_epi16((short)vtx_stride) : _mm_set1_epi32(vtx_stride);
+    for (; s < segments; s++, dst += idx_stride)
+    {
+        for (int r = 0; r < regs; r++)
+            _mm_storeu_si128((__m128i*)(dst + r * lanes), sizeof(ImDrawIdx) == 2 ? _mm_add_epi16(pat[r], b) : _mm_add_epi32(pat[r], b));
+        b = sizeof(ImDrawIdx) == 2 ? _mm_add_epi16(b, step) : _mm_add_epi32(b, step);
+    }
+    base += s * vtx_stride;
+#endif
+    for (; s < segments; s++, dst += idx_stride, base += vtx_stride)
+        for (int i = 0; i < idx_stride; i++)
+            dst[i] = (ImDrawIdx)(base + pattern[i]);
+}
+
+// Level of detail for ImDrawListFlags_DecimateLines: of each run of consecutive points within the same pixel column, only keep the
+// first and last ones and the lowest and highest ones, in their order. A line sampled more densely than the screen comes down to
+// at most 4 points per column and keeps its peaks, a line going back and forth across columns is not reduced. Returns the number of points written.
+static int PolylineDecimate(const ImVec2* points, int points_count, ImVec2* out)
+{
+    int out_count = 0;
+    for (int i_first = 0; i_first < points_count; )
+    {
+        const float column_min = ImFloorStd(points[i_first].x);
+        const float column_max = column_min + 1.0f;
+        int i_last = i_first, i_low = i_first, i_high = i_first;
+        while (i_last + 1 < points_count && points[i_last + 1].x >= column_min && points[i_last + 1].x < column_max)
+        {
+            i_last++;
+            if (points[i_last].y < points[i_low].y)
+                i_low = i_last;
+            if (points[i_last].y > points[i_high].y)
+                i_high = i_last;
+        }
+        const int i_a = ImMin(i_low, i_high);
+        const int i_b = ImMax(i_low, i_high);
+        out[out_count++] = points[i_first];
+        if (i_a != i_first && i_a != i_last)
+            out[out_count++] = points[i_a];
+        if (i_b != i_a && i_b != i_first && i_b != i_last)
+            out[out_count++] = points[i_b];
+        if (i_last != i_first)
+            out[out_count++] = points[i_last];
+        i_first = i_last + 1;
+    }
+    return out_count;
+}
+
 // TODO: Thickness anti-aliased lines cap are missing their AA fringe.
 // We avoid using the ImVec2 math operators here to reduce cost to a minimum for debug/non-inlined builds.
 void ImDrawList::AddPolyline(const ImVec2* points, const int points_count, ImU32 col, bool closed, float thickness)
@@ -627,6 +829,21 @@ void ImDrawList::AddPolyline(const ImVec2* points, const int points_count, ImU32
     if (points_count < 2)
         return;
 
+    if ((Flags & ImDrawListFlags_DecimateLines) && points_count > IM_DRAWLIST_DECIMATE_MIN_POINTS)
+    {
+        // Tessellate the decimated line instead, it never has more points than the original
+        const size_t temp_size = points_count * sizeof(ImVec2);
+        const bool temp_on_heap = temp_size > IM_DRAWLIST_ALLOCA_MAX_SIZE;
+        ImVec2* temp_points = (ImVec2*)(temp_on_heap ? IM_ALLOC(temp_size) : alloca(temp_size)); //-V630
+        const int temp_points_count = PolylineDecimate(points, points_count, temp_points);
+        Flags &= ~ImDrawListFlags_DecimateLines;
+        AddPolyline(temp_points, temp_points_count, col, closed, thickness);
+        Flags |= ImDrawListFlags_DecimateLines;
+        if (temp_on_heap)
+            IM_FREE(temp_points);
+        return;
+    }
+
     const ImVec2 uv = _Data->TexUvWhitePixel;
 
     int count = points_count;
@@ -644,136 +861,47 @@ void ImDrawList::AddPolyline(const ImVec2* points, const int points_count, ImU32
         const int vtx_count = thick_line ? points_count*4 : points_count*3;
         PrimReserve(idx_count, vtx_count);
 
-        // Temporary buffer
-        ImVec2* temp_normals = (ImVec2*)alloca(points_count * (thick_line ? 5 : 3) * sizeof(ImVec2)); //-V630
-        ImVec2* temp_points = temp_normals + points_count;
+        // Temporary buffer: the normal of each segment, then the offset of each point
+        const size_t temp_size = points_count * 2 * sizeof(ImVec2);
+        const bool temp_on_heap = temp_size > IM_DRAWLIST_ALLOCA_MAX_SIZE;
+        ImVec2* temp_normals = (ImVec2*)(temp_on_heap ? IM_ALLOC(temp_size) : alloca(temp_size)); //-V630
+        ImVec2* temp_offsets = temp_normals + points_count;
 
-        for (int i1 = 0; i1 < count; i1++)
-        {
-            const int i2 = (i1+1) == points_count ? 0 : i1+1;
-            float dx = points[i2].x - points[i1].x;
-            float dy = points[i2].y - points[i1].y;
-            IM_NORMALIZE2F_OVER_ZERO(dx, dy);
-            temp_normals[i1].x = dy;
-            temp_normals[i1].y = -dx;
-        }
-        if (!closed)
+        PolylineNormals(points, points_count - 1, temp_normals);
+        if (closed)
+            PolylineNormal(points[points_count-1], points[0], temp_normals[points_count-1]);
+        else
             temp_normals[points_count-1] = temp_normals[points_count-2];
 
-        if (!thick_line)
-        {
-            if (!closed)
-            {
-                temp_points[0] = points[0] + temp_normals[0] * AA_SIZE;
-                temp_points[1] = points[0] - temp_normals[0] * AA_SIZE;
-                temp_points[(points_count-1)*2+0] = points[points_count-1] + temp_normals[points_count-1] * AA_SIZE;
-                temp_points[(points_count-1)*2+1] = points[points_count-1] - temp_normals[points_count-1] * AA_SIZE;
-            }
-
-            // FIXME-OPT: Merge the different loops, possibly remove the temporary buffer.
-            unsigned int idx1 = _VtxCurrentIdx;
-            for (int i1 = 0; i1 < count; i1++)
-            {
-                const int i2 = (i1+1) == points_count ? 0 : i1+1;
-                unsigned int idx2 = (i1+1) == points_count ? _VtxCurrentIdx : idx1+3;
-
-                // Average normals
-                float dm_x = (temp_normals[i1].x + temp_normals[i2].x) * 0.5f;
-                float dm_y = (temp_normals[i1].y + temp_normals[i2].y) * 0.5f;
-                IM_FIXNORMAL2F(dm_x, dm_y);
-                dm_x *= AA_SIZE;
-                dm_y *= AA_SIZE;
-
-                // Add temporary vertexes
-                ImVec2* out_vtx = &temp_points[i2*2];
-                out_vtx[0].x = points[i2].x + dm_x;
-                out_vtx[0].y = points[i2].y + dm_y;
-                out_vtx[1].x = points[i2].x - dm_x;
-                out_vtx[1].y = points[i2].y - dm_y;
-
-                // Add indexes
-                _IdxWritePtr[0] = (ImDrawIdx)(idx2+0); _IdxWritePtr[1] = (ImDrawIdx)(idx1+0); _IdxWritePtr[2] = (ImDrawIdx)(idx1+2);
-                _IdxWritePtr[3] = (ImDrawIdx)(idx1+2); _IdxWritePtr[4] = (ImDrawIdx)(idx2+2); _IdxWritePtr[5] = (ImDrawIdx)(idx2+0);
-                _IdxWritePtr[6] = (ImDrawIdx)(idx2+1); _IdxWritePtr[7] = (ImDrawIdx)(idx1+1); _IdxWritePtr[8] = (ImDrawIdx)(idx1+0);
-                _IdxWritePtr[9] = (ImDrawIdx)(idx1+0); _IdxWritePtr[10]= (ImDrawIdx)(idx2+0); _IdxWritePtr[11]= (ImDrawIdx)(idx2+1);
-                _IdxWritePtr += 12;
-
-                idx1 = idx2;
-            }
-
-            // Add vertexes
-            for (int i = 0; i < points_count; i++)
-            {
-                _VtxWritePtr[0].pos = points[i];          _VtxWritePtr[0].uv = uv; _VtxWritePtr[0].col = col;
-                _VtxWritePtr[1].pos = temp_points[i*2+0]; _VtxWritePtr[1].uv = uv; _VtxWritePtr[1].col = col_trans;
-                _VtxWritePtr[2].pos = temp_points[i*2+1]; _VtxWritePtr[2].uv = uv; _VtxWritePtr[2].col = col_trans;
-                _VtxWritePtr += 3;
-            }
-        }
+        // Points are offset by their averaged normals, except the ends of an open line which use the normal of their segment
+        PolylineMiters(temp_normals, points_count, temp_offsets);
+        if (closed)
+            PolylineMiter(temp_normals[points_count-1], temp_normals[0], temp_offsets[0]);
         else
-        {
-            const float half_inner_thickness = (thickness - AA_SIZE) * 0.5f;
-            if (!closed)
-            {
-                temp_points[0] = points[0] + temp_normals[0] * (half_inner_thickness + AA_SIZE);
-                temp_points[1] = points[0] + temp_normals[0] * (half_inner_thickness);
-                temp_points[2] = points[0] - temp_normals[0] * (half_inner_thickness);
-                temp_points[3] = points[0] - temp_normals[0] * (half_inner_thickness + AA_SIZE);
-                temp_points[(points_count-1)*4+0] = points[points_count-1] + temp_normals[points_count-1] * (half_inner_thickness + AA_SIZE);
-                temp_points[(points_count-1)*4+1] = points[points_count-1] + temp_normals[points_count-1] * (half_inner_thickness);
-                temp_points[(points_count-1)*4+2] = points[points_count-1] - temp_normals[points_count-1] * (half_inner_thickness);
-                temp_points[(points_count-1)*4+3] = points[points_count-1] - temp_normals[points_count-1] * (half_inner_thickness + AA_SIZE);
-            }
+            temp_offsets[0] = temp_normals[0];
 
-            // FIXME-OPT: Merge the different loops, possibly remove the temporary buffer.
-            unsigned int idx1 = _VtxCurrentIdx;
-            for (int i1 = 0; i1 < count; i1++)
-            {
-                const int i2 = (i1+1) == points_count ? 0 : i1+1;
-                unsigned int idx2 = (i1+1) == points_count ? _VtxCurrentIdx : idx1+4;
-
-                // Average normals
-                float dm_x = (temp_normals[i1].x + temp_normals[i2].x) * 0.5f;
-                float dm_y = (temp_normals[i1].y + temp_normals[i2].y) * 0.5f;
-                IM_FIXNORMAL2F(dm_x, dm_y);
-                float dm_out_x = dm_x * (half_inner_thickness + AA_SIZE);
-                float dm_out_y = dm_y * (half_inner_thickness + AA_SIZE);
-                float dm_in_x = dm_x * half_inner_thickness;
-                float dm_in_y = dm_y * half_inner_thickness;
-
-                // Add temporary vertexes
-                ImVec2* out_vtx = &temp_points[i2*4];
-                out_vtx[0].x = points[i2].x + dm_out_x;
-                out_vtx[0].y = points[i2].y + dm_out_y;
-                out_vtx[1].x = points[i2].x + dm_in_x;
-                out_vtx[1].y = points[i2].y + dm_in_y;
-                out_vtx[2].x = points[i2].x - dm_in_x;
-                out_vtx[2].y = points[i2].y - dm_in_y;
-                out_vtx[3].x = points[i2].x - dm_out_x;
-                out_vtx[3].y = points[i2].y - dm_out_y;
-
-                // Add indexes
-                _IdxWritePtr[0]  = (ImDrawIdx)(idx2+1); _IdxWritePtr[1]  = (ImDrawIdx)(idx1+1); _IdxWritePtr[2]  = (ImDrawIdx)(idx1+2);
-                _IdxWritePtr[3]  = (ImDrawIdx)(idx1+2); _IdxWritePtr[4]  = (ImDrawIdx)(idx2+2); _IdxWritePtr[5]  = (ImDrawIdx)(idx2+1);
-                _IdxWritePtr[6]  = (ImDrawIdx)(idx2+1); _IdxWritePtr[7]  = (ImDrawIdx)(idx1+1); _IdxWritePtr[8]  = (ImDrawIdx)(idx1+0);
-                _IdxWritePtr[9]  = (ImDrawIdx)(idx1+0); _IdxWritePtr[10] = (ImDrawIdx)(idx2+0); _IdxWritePtr[11] = (ImDrawIdx)(idx2+1);
-                _IdxWritePtr[12] = (ImDrawIdx)(idx2+2); _IdxWritePtr[13] = (ImDrawIdx)(idx1+2); _IdxWritePtr[14] = (ImDrawIdx)(idx1+3);
-                _IdxWritePtr[15] = (ImDrawIdx)(idx1+3); _IdxWritePtr[16] = (ImDrawIdx)(idx2+3); _IdxWritePtr[17] = (ImDrawIdx)(idx2+2);
-                _IdxWritePtr += 18;
-
-                idx1 = idx2;
-            }
-
-            // Add vertexes
-            for (int i = 0; i < points_count; i++)
-            {
-                _VtxWritePtr[0].pos = temp_points[i*4+0]; _VtxWritePtr[0].uv = uv; _VtxWritePtr[0].col = col_trans;
-                _VtxWritePtr[1].pos = temp_points[i*4+1]; _VtxWritePtr[1].uv = uv; _VtxWritePtr[1].col = col;
-                _VtxWritePtr[2].pos = temp_points[i*4+2]; _VtxWritePtr[2].uv = uv; _VtxWritePtr[2].col = col;
-                _VtxWritePtr[3].pos = temp_points[i*4+3]; _VtxWritePtr[3].uv = uv; _VtxWritePtr[3].col = col_trans;
-                _VtxWritePtr += 4;
-            }
-        }
+        // Add vertexes: (point, outer, outer) or (outer, inner, inner, outer) with the fringes transparent
+        const float half_inner_thickness = (thickness - AA_SIZE) * 0.5f;
+        if (!thick_line)
+            PolylineVertices(_VtxWritePtr, points, temp_offsets, points_count, false, AA_SIZE, 0.0f, uv, col, col_trans);
+        else
+            PolylineVertices(_VtxWritePtr, points, temp_offsets, points_count, true, half_inner_thickness + AA_SIZE, half_inner_thickness, uv, col, col_trans);
+        _VtxWritePtr += vtx_count;
+
+        // Add indexes: segment i joins the vertexes of points i and i+1, the last one of a closed line wraps to the first point
+        const int vtx_stride = thick_line ? 4 : 3;
+        const int idx_stride = thick_line ? 18 : 12;
+        const ImDrawIdx* pattern = thick_line ? PolylineIdxThick : PolylineIdxThin;
+        PolylineIndices(_IdxWritePtr, pattern, idx_stride, count - 1, _VtxCurrentIdx, vtx_stride);
+        _IdxWritePtr += (count - 1) * idx_stride;
+        const unsigned int idx1 = _VtxCurrentIdx + (count - 1) * vtx_stride;
+        const unsigned int idx2 = (count == points_count) ? _VtxCurrentIdx : idx1 + vtx_stride;
+        for (int i = 0; i < idx_stride; i++)
+            _IdxWritePtr[i] = (ImDrawIdx)(((int)pattern[i] < vtx_stride ? idx1 : idx2 - vtx_stride) + pattern[i]);
+        _IdxWritePtr += idx_stride;
+
+        if (temp_on_heap)
+            IM_FREE(temp_normals);
         _VtxCurrentIdx += (ImDrawIdx)vtx_count;
     }
     else
@@ -836,7 +964,9 @@ void ImDrawList::AddConvexPolyFilled(const ImVec2* points, const int points_coun
         }
 
         // Compute normals
-        ImVec2* temp_normals = (ImVec2*)alloca(points_count * sizeof(ImVec2)); //-V630
+        const size_t temp_size = points_count * sizeof(ImVec2);
+        const bool temp_on_heap = temp_size > IM_DRAWLIST_ALLOCA_MAX_SIZE;
+        ImVec2* temp_normals = (ImVec2*)(temp_on_heap ? IM_ALLOC(temp_size) : alloca(temp_size)); //-V630
         for (int i0 = points_count-1, i1 = 0; i1 < points_count; i0 = i1++)
         {
             const ImVec2& p0 = points[i0];
@@ -869,6 +999,8 @@ void ImDrawList::AddConvexPolyFilled(const ImVec2* points, const int points_coun
             _IdxWritePtr[3] = (ImDrawIdx)(vtx_outer_idx+(i0<<1)); _IdxWritePtr[4] = (ImDrawIdx)(vtx_outer_idx+(i1<<1)); _IdxWritePtr[5] = (ImDrawIdx)(vtx_inner_idx+(i1<<1));
             _IdxWritePtr += 6;
         }
+        if (temp_on_heap)
+            IM_FREE(temp_normals);
         _VtxCurrentIdx += (ImDrawIdx)vtx_count;
     }
     else
@@ -1203,6 +1335,216 @@ void ImDrawList::AddBezierCurve(const ImVec2& p1, const ImVec2& p2, const ImVec2
     PathStroke(col, false, thickness);
 }
 
+// Batched primitives: the same vertices and indices as calling AddRectFilled(), AddLine() and AddCircleFilled() for each
+// element, written in one loop into reservations of up to IM_DRAWLIST_BATCH_VTX_MAX vertices instead of a PrimReserve() each.
+// 'idx_left'/'vtx_left' track what is left of the current reservation, released with PrimUnreserve() at the end.
+static inline void PrimReserveBatch(ImDrawList* draw_list, int idx_count, int vtx_count, int remaining, int* idx_left, int* vtx_left)
+{
+    if (idx_count <= *idx_left && vtx_count <= *vtx_left)
+        return;
+    draw_list->PrimUnreserve(*idx_left, *vtx_left);
+    const int batch = ImMax(ImMin(remaining, IM_DRAWLIST_BATCH_VTX_MAX / vtx_count), 1);
+    *idx_left = batch * idx_count;
+    *vtx_left = batch * vtx_count;
+    draw_list->PrimReserve(*idx_left, *vtx_left);
+}
+
+void ImDrawList::AddRectsFilled(const ImVec2* p_min, const ImVec2* p_max, const ImU32* col, int count)
+{
+    const ImVec2 uv = _Data->TexUvWhitePixel;
+    int idx_left = 0, vtx_left = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if ((col[i] & IM_COL32_A_MASK) == 0)
+            continue;
+        PrimReserveBatch(this, 6, 4, count - i, &idx_left, &vtx_left);
+        const ImVec2& a = p_min[i];
+        const ImVec2& c = p_max[i];
+        const unsigned int idx = _VtxCurrentIdx;
+        _IdxWritePtr[0] = (ImDrawIdx)idx; _IdxWritePtr[1] = (ImDrawIdx)(idx+1); _IdxWritePtr[2] = (ImDrawIdx)(idx+2);
+        _IdxWritePtr[3] = (ImDrawIdx)idx; _IdxWritePtr[4] = (ImDrawIdx)(idx+2); _IdxWritePtr[5] = (ImDrawIdx)(idx+3);
+        _VtxWritePtr[0].pos = a;                 _VtxWritePtr[0].uv = uv; _VtxWritePtr[0].col = col[i];
+        _VtxWritePtr[1].pos = ImVec2(c.x, a.y);  _VtxWritePtr[1].uv = uv; _VtxWritePtr[1].col = col[i];
+        _VtxWritePtr[2].pos = c;                 _VtxWritePtr[2].uv = uv; _VtxWritePtr[2].col = col[i];
+        _VtxWritePtr[3].pos = ImVec2(a.x, c.y);  _VtxWritePtr[3].uv = uv; _VtxWritePtr[3].col = col[i];
+        _VtxWritePtr += 4;
+        _VtxCurrentIdx += 4;
+        _IdxWritePtr += 6;
+        idx_left -= 6;
+        vtx_left -= 4;
+    }
+    PrimUnreserve(idx_left, vtx_left);
+}
+
+// Each line is the two points AddPolyline() stroke of AddLine(), see there for the layout of the anti-aliased fringes.
+void ImDrawList::AddLines(const ImVec2* p1, const ImVec2* p2, const ImU32* col, int count, float thickness)
+{
+    const ImVec2 uv = _Data->TexUvWhitePixel;
+    const bool anti_aliased = (Flags & ImDrawListFlags_AntiAliasedLines) != 0;
+    const bool thick_line = thickness > 1.0f;
+    const int idx_count = anti_aliased ? (thick_line ? 18 : 12) : 6;
+    const int vtx_count = anti_aliased ? (thick_line ? 8 : 6) : 4;
+    const float AA_SIZE = 1.0f;
+    const float half_inner_thickness = (thickness - AA_SIZE) * 0.5f;
+    int idx_left = 0, vtx_left = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if ((col[i] & IM_COL32_A_MASK) == 0)
+            continue;
+        PrimReserveBatch(this, idx_count, vtx_count, count - i, &idx_left, &vtx_left);
+        const ImVec2 a(p1[i].x + 0.5f, p1[i].y + 0.5f);
+        const ImVec2 b(p2[i].x + 0.5f, p2[i].y + 0.5f);
+        const ImU32 c = col[i];
+        float dx = b.x - a.x;
+        float dy = b.y - a.y;
+        IM_NORMALIZE2F_OVER_ZERO(dx, dy);
+        const unsigned int idx1 = _VtxCurrentIdx;
+        if (!anti_aliased)
+        {
+            dx *= (thickness * 0.5f);
+            dy *= (thickness * 0.5f);
+            _VtxWritePtr[0].pos.x = a.x + dy; _VtxWritePtr[0].pos.y = a.y - dx; _VtxWritePtr[0].uv = uv; _VtxWritePtr[0].col = c;
+            _VtxWritePtr[1].pos.x = b.x + dy; _VtxWritePtr[1].pos.y = b.y - dx; _VtxWritePtr[1].uv = uv; _VtxWritePtr[1].col = c;
+            _VtxWritePtr[2].pos.x = b.x - dy; _VtxWritePtr[2].pos.y = b.y + dx; _VtxWritePtr[2].uv = uv; _VtxWritePtr[2].col = c;
+            _VtxWritePtr[3].pos.x = a.x - dy; _VtxWritePtr[3].pos.y = a.y + dx; _VtxWritePtr[3].uv = uv; _VtxWritePtr[3].col = c;
+            _IdxWritePtr[0] = (ImDrawIdx)(idx1); _IdxWritePtr[1] = (ImDrawIdx)(idx1+1); _IdxWritePtr[2] = (ImDrawIdx)(idx1+2);
+            _IdxWritePtr[3] = (ImDrawIdx)(idx1); _IdxWritePtr[4] = (ImDrawIdx)(idx1+2); _IdxWritePtr[5] = (ImDrawIdx)(idx1+3);
+        }
+        else
+        {
+            // Normal (nx, ny) at the first point, averaged and fixed up (dm_x, dm_y) at the last one
+            const ImU32 col_trans = c & ~IM_COL32_A_MASK;
+            const float nx = dy, ny = -dx;
+            float dm_x = (nx + nx) * 0.5f;
+            float dm_y = (ny + ny) * 0.5f;
+            IM_FIXNORMAL2F(dm_x, dm_y);
+            if (!thick_line)
+            {
+                dm_x *= AA_SIZE;
+                dm_y *= AA_SIZE;
+                const unsigned int idx2 = idx1 + 3;
+                _VtxWritePtr[0].pos = a;                                                        _VtxWritePtr[0].uv = uv; _VtxWritePtr[0].col = c;
+                _VtxWritePtr[1].pos.x = a.x + nx * AA_SIZE; _VtxWritePtr[1].pos.y = a.y + ny * AA_SIZE; _VtxWritePtr[1].uv = uv; _VtxWritePtr[1].col = col_trans;
+                _VtxWritePtr[2].pos.x = a.x - nx * AA_SIZE; _VtxWritePtr[2].pos.y = a.y - ny * AA_SIZE; _VtxWritePtr[2].uv = uv; _VtxWritePtr[2].col = col_trans;
+                _VtxWritePtr[3].pos = b;                                                        _VtxWritePtr[3].uv = uv; _VtxWritePtr[3].col = c;
+                _VtxWritePtr[4].pos.x = b.x + dm_x;         _VtxWritePtr[4].pos.y = b.y + dm_y;         _VtxWritePtr[4].uv = uv; _VtxWritePtr[4].col = col_trans;
+                _VtxWritePtr[5].pos.x = b.x - dm_x;         _VtxWritePtr[5].pos.y = b.y - dm_y;         _VtxWritePtr[5].uv = uv; _VtxWritePtr[5].col = col_trans;
+                _IdxWritePtr[0] = (ImDrawIdx)(idx2+0); _IdxWritePtr[1] = (ImDrawIdx)(idx1+0); _IdxWritePtr[2] = (ImDrawIdx)(idx1+2);
+                _IdxWritePtr[3] = (ImDrawIdx)(idx1+2); _IdxWritePtr[4] = (ImDrawIdx)(idx2+2); _IdxWritePtr[5] = (ImDrawIdx)(idx2+0);
+                _IdxWritePtr[6] = (ImDrawIdx)(idx2+1); _IdxWritePtr[7] = (ImDrawIdx)(idx1+1); _IdxWritePtr[8] = (ImDrawIdx)(idx1+0);
+                _IdxWritePtr[9] = (ImDrawIdx)(idx1+0); _IdxWritePtr[10]= (ImDrawIdx)(idx2+0); _IdxWritePtr[11]= (ImDrawIdx)(idx2+1);
+            }
+            else
+            {
+                const float out_size = half_inner_thickness + AA_SIZE;
+                const float dm_out_x = dm_x * out_size, dm_out_y = dm_y * out_size;
+                const float dm_in_x = dm_x * half_inner_thickness, dm_in_y = dm_y * half_inner_thickness;
+                const unsigned int idx2 = idx1 + 4;
+                _VtxWritePtr[0].pos.x = a.x + nx * out_size;             _VtxWritePtr[0].pos.y = a.y + ny * out_size;             _VtxWritePtr[0].uv = uv; _VtxWritePtr[0].col = col_trans;
+                _VtxWritePtr[1].pos.x = a.x + nx * half_inner_thickness; _VtxWritePtr[1].pos.y = a.y + ny * half_inner_thickness; _VtxWritePtr[1].uv = uv; _VtxWritePtr[1].col = c;
+                _VtxWritePtr[2].pos.x = a.x - nx * half_inner_thickness; _VtxWritePtr[2].pos.y = a.y - ny * half_inner_thickness; _VtxWritePtr[2].uv = uv; _VtxWritePtr[2].col = c;
+                _VtxWritePtr[3].pos.x = a.x - nx * out_size;             _VtxWritePtr[3].pos.y = a.y - ny * out_size;             _VtxWritePtr[3].uv = uv; _VtxWritePtr[3].col = col_trans;
+                _VtxWritePtr[4].pos.x = b.x + dm_out_x;                  _VtxWritePtr[4].pos.y = b.y + dm_out_y;                  _VtxWritePtr[4].uv = uv; _VtxWritePtr[4].col = col_trans;
+                _VtxWritePtr[5].pos.x = b.x + dm_in_x;                   _VtxWritePtr[5].pos.y = b.y + dm_in_y;                   _VtxWritePtr[5].uv = uv; _VtxWritePtr[5].col = c;
+                _VtxWritePtr[6].pos.x = b.x - dm_in_x;                   _VtxWritePtr[6].pos.y = b.y - dm_in_y;                   _VtxWritePtr[6].uv = uv; _VtxWritePtr[6].col = c;
+                _VtxWritePtr[7].pos.x = b.x - dm_out_x;                  _VtxWritePtr[7].pos.y = b.y - dm_out_y;                  _VtxWritePtr[7].uv = uv; _VtxWritePtr[7].col = col_trans;
+                _IdxWritePtr[0]  = (ImDrawIdx)(idx2+1); _IdxWritePtr[1]  = (ImDrawIdx)(idx1+1); _IdxWritePtr[2]  = (ImDrawIdx)(idx1+2);
+                _IdxWritePtr[3]  = (ImDrawIdx)(idx1+2); _IdxWritePtr[4]  = (ImDrawIdx)(idx2+2); _IdxWritePtr[5]  = (ImDrawIdx)(idx2+1);
+                _IdxWritePtr[6]  = (ImDrawIdx)(idx2+1); _IdxWritePtr[7]  = (ImDrawIdx)(idx1+1); _IdxWritePtr[8]  = (ImDrawIdx)(idx1+0);
+                _IdxWritePtr[9]  = (ImDrawIdx)(idx1+0); _IdxWritePtr[10] = (ImDrawIdx)(idx2+0); _IdxWritePtr[11] = (ImDrawIdx)(idx2+1);
+                _IdxWritePtr[12] = (ImDrawIdx)(idx2+2); _IdxWritePtr[13] = (ImDrawIdx)(idx1+2); _IdxWritePtr[14] = (ImDrawIdx)(idx1+3);
+                _IdxWritePtr[15] = (ImDrawIdx)(idx1+3); _IdxWritePtr[16] = (ImDrawIdx)(idx2+3); _IdxWritePtr[17] = (ImDrawIdx)(idx2+2);
+            }
+        }
+        _VtxWritePtr += vtx_count;
+        _VtxCurrentIdx += vtx_count;
+        _IdxWritePtr += idx_count;
+        idx_left -= idx_count;
+        vtx_left -= vtx_count;
+    }
+    PrimUnreserve(idx_left, vtx_left);
+}
+
+// The points of a circle are its center plus the radius times a unit circle, computed once per segment count.
+// Anti-aliased fills go through AddConvexPolyFilled() for each circle.
+void ImDrawList::AddCirclesFilled(const ImVec2* center, const float* radius, const ImU32* col, int count, int num_segments)
+{
+    IM_STATIC_ASSERT(12 * IM_DRAWLIST_ARCFAST_TESSELLATION_MULTIPLIER < IM_DRAWLIST_CIRCLE_AUTO_SEGMENT_MAX);
+    ImVec2 unit[IM_DRAWLIST_CIRCLE_AUTO_SEGMENT_MAX];
+    ImVec2 points[IM_DRAWLIST_CIRCLE_AUTO_SEGMENT_MAX];
+    int unit_segments = 0, points_count = 0;
+    const ImVec2 uv = _Data->TexUvWhitePixel;
+    const bool anti_aliased = (Flags & ImDrawListFlags_AntiAliasedFill) != 0;
+    int idx_left = 0, vtx_left = 0;
+    for (int i = 0; i < count; i++)
+    {
+        const float r = radius[i];
+        if ((col[i] & IM_COL32_A_MASK) == 0 || r <= 0.0f)
+            continue;
+
+        // Obtain segment count, as AddCircleFilled()
+        int segments = num_segments;
+        if (segments <= 0)
+        {
+            const int radius_idx = (int)r - 1;
+            if (radius_idx < IM_ARRAYSIZE(_Data->CircleSegmentCounts))
+                segments = _Data->CircleSegmentCounts[radius_idx];
+            else
+                segments = IM_DRAWLIST_CIRCLE_AUTO_SEGMENT_CALC(r, _Data->CircleSegmentMaxError);
+        }
+        else
+        {
+            segments = ImClamp(segments, 3, IM_DRAWLIST_CIRCLE_AUTO_SEGMENT_MAX);
+        }
+        if (segments != unit_segments)
+        {
+            // The 12 segments circle is PathArcToFast(), which repeats its first point at the end
+            unit_segments = segments;
+            if (segments == 12)
+            {
+                points_count = 12 * IM_DRAWLIST_ARCFAST_TESSELLATION_MULTIPLIER + 1;
+                for (int n = 0; n < points_count; n++)
+                    unit[n] = _Data->ArcFastVtx[n % IM_ARRAYSIZE(_Data->ArcFastVtx)];
+            }
+            else
+            {
+                points_count = segments;
+                const float a_max = (IM_PI * 2.0f) * ((float)segments - 1.0f) / (float)segments;
+                for (int n = 0; n < points_count; n++)
+                {
+                    const float a = ((float)n / (float)(segments - 1)) * a_max;
+                    unit[n] = ImVec2(ImCos(a), ImSin(a));
+                }
+            }
+        }
+
+        const ImVec2& c = center[i];
+        if (anti_aliased)
+        {
+            for (int n = 0; n < points_count; n++)
+                points[n] = ImVec2(c.x + unit[n].x * r, c.y + unit[n].y * r);
+            AddConvexPolyFilled(points, points_count, col[i]);
+            continue;
+        }
+        const int idx_count = (points_count - 2) * 3;
+        PrimReserveBatch(this, idx_count, points_count, count - i, &idx_left, &vtx_left);
+        for (int n = 0; n < points_count; n++)
+        {
+            _VtxWritePtr[n].pos.x = c.x + unit[n].x * r; _VtxWritePtr[n].pos.y = c.y + unit[n].y * r; _VtxWritePtr[n].uv = uv; _VtxWritePtr[n].col = col[i];
+        }
+        for (int n = 2; n < points_count; n++)
+        {
+            _IdxWritePtr[0] = (ImDrawIdx)(_VtxCurrentIdx); _IdxWritePtr[1] = (ImDrawIdx)(_VtxCurrentIdx+n-1); _IdxWritePtr[2] = (ImDrawIdx)(_VtxCurrentIdx+n);
+            _IdxWritePtr += 3;
+        }
+        _VtxWritePtr += points_count;
+        _VtxCurrentIdx += points_count;
+        idx_left -= idx_count;
+        vtx_left -= points_count;
+    }
+    PrimUnreserve(idx_left, vtx_left);
+}
+
 void ImDrawList::AddText(const ImFont* font, float font_size, const ImVec2& pos, ImU32 col, const char* text_begin, const char* text_end, float wrap_width, const ImVec4* cpu_fine_clip_rect)
 {
     if ((col & IM_COL32_A_MASK) == 0)
@@ -1422,6 +1764,168 @@ void ImDrawListSplitter::SetCurrentChannel(ImDrawList* draw_list, int idx)
     draw_list->_IdxWritePtr = draw_list->IdxBuffer.Data + draw_list->IdxBuffer.Size;
 }
 
+//-----------------------------------------------------------------------------
+// [SECTION] ImDrawListCache
+//-----------------------------------------------------------------------------
+
+void ImDrawListCache::ClearFreeMemory()
+{
+    IM_ASSERT(_Current == -1 && "Missing EndRecord()");
+    for (int i = 0; i < _Recordings.Size; i++)
+    {
+        _Recordings[i]._CmdBuffer.clear();
+        _Recordings[i]._IdxBuffer.clear();
+        _Recordings[i]._VtxBuffer.clear();
+    }
+    _Recordings.clear();
+    _Map.Clear();
+}
+
+void ImDrawListCache::BeginRecord(ImDrawList* draw_list, ImGuiID key, ImU32 hash, const ImVec2& origin)
+{
+    IM_ASSERT(_Current == -1 && "Nested recording is not supported. Please use separate instances of ImDrawListCache.");
+    IM_ASSERT(draw_list->CmdBuffer.Size > 0);
+    int rec_n = _Map.GetInt(key, 0) - 1;
+    if (rec_n < 0)
+    {
+        rec_n = _Recordings.Size;
+        _Recordings.resize(rec_n + 1);
+        IM_PLACEMENT_NEW(&_Recordings[rec_n]) ImDrawListRecording();
+        _Map.SetInt(key, rec_n + 1);
+    }
+
+    // A previous recording under the same key is overwritten, we keep its allocations
+    ImDrawListRecording& rec = _Recordings[rec_n];
+    rec._Hash = hash;
+    rec._Origin = origin;
+    rec._CmdBuffer.resize(0);
+    rec._IdxBuffer.resize(0);
+    rec._VtxBuffer.resize(0);
+    _Current = rec_n;
+    _CmdStart = draw_list->CmdBuffer.Size - 1;
+    _IdxStart = draw_list->IdxBuffer.Size;
+    _VtxStart = draw_list->VtxBuffer.Size;
+}
+
+void ImDrawListCache::EndRecord(ImDrawList* draw_list)
+{
+    IM_ASSERT(_Current != -1 && "Missing BeginRecord()");
+    IM_ASSERT(draw_list->IdxBuffer.Size >= _IdxStart && draw_list->VtxBuffer.Size >= _VtxStart);
+    ImDrawListRecording& rec = _Recordings[_Current];
+    _Current = -1;
+
+    rec._VtxBuffer.resize(draw_list->VtxBuffer.Size - _VtxStart);
+    if (rec._VtxBuffer.Size > 0)
+        memcpy(rec._VtxBuffer.Data, draw_list->VtxBuffer.Data + _VtxStart, rec._VtxBuffer.Size * sizeof(ImDrawVert));
+    rec._IdxBuffer.resize(draw_list->IdxBuffer.Size - _IdxStart);
+
+    // The command which was current in BeginRecord() may have been merged back into the previous one since (see UpdateClipRect())
+    int cmd_n = ImMin(_CmdStart, draw_list->CmdBuffer.Size - 1);
+    if (cmd_n > 0 && draw_list->CmdBuffer[cmd_n].IdxOffset > (unsigned int)_IdxStart)
+        cmd_n--;
+
+    // Keep the part of each command after the start, with its indices made relative to the first of its vertices in the recording
+    ImDrawIdx* idx_write = rec._IdxBuffer.Data;
+    for (; cmd_n < draw_list->CmdBuffer.Size; cmd_n++)
+    {
+        const ImDrawCmd& cmd = draw_list->CmdBuffer[cmd_n];
+        const unsigned int idx_begin = ImMax(cmd.IdxOffset, (unsigned int)_IdxStart);
+        const unsigned int idx_end = cmd.IdxOffset + cmd.ElemCount;
+        if (idx_end <= idx_begin && cmd.UserCallback == NULL)
+            continue;
+        const unsigned int vtx_begin = ImMax(cmd.VtxOffset, (unsigned int)_VtxStart);
+        ImDrawCmd rec_cmd = cmd;
+        rec_cmd.ElemCount = (idx_end > idx_begin) ? idx_end - idx_begin : 0;
+        rec_cmd.VtxOffset = vtx_begin - _VtxStart;
+        rec_cmd.IdxOffset = (unsigned int)(idx_write - rec._IdxBuffer.Data);
+        rec._CmdBuffer.push_back(rec_cmd);
+
+        const ImDrawIdx* idx_read = draw_list->IdxBuffer.Data + idx_begin;
+        const unsigned int idx_rebase = vtx_begin - cmd.VtxOffset;
+        if (idx_rebase == 0)
+            memcpy(idx_write, idx_read, rec_cmd.ElemCount * sizeof(ImDrawIdx));
+        else
+            for (unsigned int i = 0; i < rec_cmd.ElemCount; i++)
+                idx_write[i] = (ImDrawIdx)(idx_read[i] - idx_rebase);
+        idx_write += rec_cmd.ElemCount;
+    }
+    IM_ASSERT(idx_write == rec._IdxBuffer.Data + rec._IdxBuffer.Size);
+}
+
+bool ImDrawListCache::Replay(ImDrawList* draw_list, ImGuiID key, ImU32 hash, const ImVec2& origin)
+{
+    const int rec_n = _Map.GetInt(key, 0) - 1;
+    if (rec_n < 0 || rec_n == _Current || _Recordings[rec_n]._Hash != hash)
+        return false;
+    const ImDrawListRecording& rec = _Recordings[rec_n];
+    IM_ASSERT(draw_list->CmdBuffer.Size > 0);
+
+    // Vertices, translated to the new origin
+    const float dx = origin.x - rec._Origin.x;
+    const float dy = origin.y - rec._Origin.y;
+    const int vtx_start = draw_list->VtxBuffer.Size;
+    draw_list->VtxBuffer.resize(vtx_start + rec._VtxBuffer.Size);
+    ImDrawVert* vtx_write = draw_list->VtxBuffer.Data + vtx_start;
+    if (rec._VtxBuffer.Size > 0)
+        memcpy(vtx_write, rec._VtxBuffer.Data, rec._VtxBuffer.Size * sizeof(ImDrawVert));
+    if (dx != 0.0f || dy != 0.0f)
+        for (int i = 0; i < rec._VtxBuffer.Size; i++)
+        {
+            vtx_write[i].pos.x += dx;
+            vtx_write[i].pos.y += dy;
+        }
+
+    // Commands and indices. An empty current command is replaced by the first one.
+    const ImVec4 clip_rect = draw_list->_ClipRectStack.Size ? draw_list->_ClipRectStack.back() : draw_list->_Data->ClipRectFullscreen;
+    const ImTextureID texture_id = draw_list->_TextureIdStack.Size ? draw_list->_TextureIdStack.back() : (ImTextureID)NULL;
+    const int idx_start = draw_list->IdxBuffer.Size;
+    draw_list->IdxBuffer.resize(idx_start + rec._IdxBuffer.Size);
+    ImDrawIdx* idx_write = draw_list->IdxBuffer.Data + idx_start;
+    if (draw_list->CmdBuffer.back().ElemCount == 0 && draw_list->CmdBuffer.back().UserCallback == NULL)
+        draw_list->CmdBuffer.pop_back();
+    for (int cmd_n = 0; cmd_n < rec._CmdBuffer.Size; cmd_n++)
+    {
+        const ImDrawCmd& rec_cmd = rec._CmdBuffer[cmd_n];
+
+        // Indices are rebased on the current VtxOffset of the draw list. With 16-bit indices, when they would not fit and the
+        // back-end supports it, a new VtxOffset starts at the first vertex of the command (as in PrimReserve()).
+        const unsigned int vtx_begin = vtx_start + rec_cmd.VtxOffset;
+        if (sizeof(ImDrawIdx) == 2 && vtx_start + rec._VtxBuffer.Size - draw_list->_VtxCurrentOffset > (1 << 16) && (draw_list->Flags & ImDrawListFlags_AllowVtxOffset))
+            draw_list->_VtxCurrentOffset = vtx_begin;
+        const ImDrawIdx* idx_read = rec._IdxBuffer.Data + rec_cmd.IdxOffset;
+        const unsigned int idx_rebase = vtx_begin - draw_list->_VtxCurrentOffset;
+        if (idx_rebase == 0)
+            memcpy(idx_write, idx_read, rec_cmd.ElemCount * sizeof(ImDrawIdx));
+        else
+            for (unsigned int i = 0; i < rec_cmd.ElemCount; i++)
+                idx_write[i] = (ImDrawIdx)(idx_read[i] + idx_rebase);
+
+        ImDrawCmd cmd = rec_cmd;
+        cmd.VtxOffset = draw_list->_VtxCurrentOffset;
+        cmd.IdxOffset = (unsigned int)(idx_write - draw_list->IdxBuffer.Data);
+        cmd.ClipRect.x = ImMax(rec_cmd.ClipRect.x + dx, clip_rect.x);
+        cmd.ClipRect.y = ImMax(rec_cmd.ClipRect.y + dy, clip_rect.y);
+        cmd.ClipRect.z = ImMax(cmd.ClipRect.x, ImMin(rec_cmd.ClipRect.z + dx, clip_rect.z));
+        cmd.ClipRect.w = ImMax(cmd.ClipRect.y, ImMin(rec_cmd.ClipRect.w + dy, clip_rect.w));
+        idx_write += cmd.ElemCount;
+
+        ImDrawCmd* prev_cmd = draw_list->CmdBuffer.Size ? &draw_list->CmdBuffer.back() : NULL;
+        if (prev_cmd && CanMergeDrawCommands(prev_cmd, &cmd))
+            prev_cmd->ElemCount += cmd.ElemCount;
+        else
+            draw_list->CmdBuffer.push_back(cmd);
+    }
+
+    // Carry on with the current clip rectangle and texture
+    draw_list->_VtxWritePtr = draw_list->VtxBuffer.Data + draw_list->VtxBuffer.Size;
+    draw_list->_IdxWritePtr = idx_write;
+    draw_list->_VtxCurrentIdx = (unsigned int)draw_list->VtxBuffer.Size - draw_list->_VtxCurrentOffset;
+    ImDrawCmd* curr_cmd = draw_list->CmdBuffer.Size ? &draw_list->CmdBuffer.back() : NULL;
+    if (!curr_cmd || memcmp(&curr_cmd->ClipRect, &clip_rect, sizeof(ImVec4)) != 0 || curr_cmd->TextureId != texture_id || curr_cmd->VtxOffset != draw_list->_VtxCurrentOffset || curr_cmd->UserCallback != NULL)
+        draw_list->AddDrawCmd();
+    return true;
+}
+
 //-----------------------------------------------------------------------------
 // [SECTION] ImDrawData
 //-----------------------------------------------------------------------------
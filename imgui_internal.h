@@ -869,6 +869,19 @@ struct ImGuiColumns
 #define IM_DRAWLIST_CIRCLE_AUTO_SEGMENT_MAX                     512
 #define IM_DRAWLIST_CIRCLE_AUTO_SEGMENT_CALC(_RAD,_MAXERROR)    ImClamp((int)((IM_PI * 2.0f) / ImAcos(((_RAD) - (_MAXERROR)) / (_RAD))), IM_DRAWLIST_CIRCLE_AUTO_SEGMENT_MIN, IM_DRAWLIST_CIRCLE_AUTO_SEGMENT_MAX)
 
+// ImDrawList: Vertices reserved at once by the batched primitives (AddRectsFilled(), AddLines(), AddCirclesFilled()).
+// Must stay well below 64K so a reservation can be addressed by 16-bit indices from its own ImDrawCmd::VtxOffset.
+#define IM_DRAWLIST_BATCH_VTX_MAX                               16384
+
+// ImDrawList: With ImDrawListFlags_DecimateLines, shorter polylines are left as they are (most shapes of the UI itself).
+#define IM_DRAWLIST_DECIMATE_MIN_POINTS                         256
+
+// ImDrawList: Largest temporary buffer of AddPolyline()/AddConvexPolyFilled() taken on the stack with alloca(), larger ones
+// (long polylines) are allocated on the heap.
+#ifndef IM_DRAWLIST_ALLOCA_MAX_SIZE
+#define IM_DRAWLIST_ALLOCA_MAX_SIZE                             (16 * 1024)
+#endif
+
 // ImDrawList: You may set this to higher values (e.g. 2 or 3) to increase tessellation of fast rounded corners path.
 #ifndef IM_DRAWLIST_ARCFAST_TESSELLATION_MULTIPLIER
 #define IM_DRAWLIST_ARCFAST_TESSELLATION_MULTIPLIER             1
@@ -5946,30 +5946,79 @@ void ImGui::PlotEx(ImGuiPlotType plot_type, const char* label, float (*values_ge
         const ImU32 col_base = GetColorU32((plot_type == ImGuiPlotType_Lines) ? ImGuiCol_PlotLines : ImGuiCol_PlotHistogram);
         const ImU32 col_hovered = GetColorU32((plot_type == ImGuiPlotType_Lines) ? ImGuiCol_PlotLinesHovered : ImGuiCol_PlotHistogramHovered);
 
-        for (int n = 0; n < res_w; n++)
+        if (plot_type == ImGuiPlotType_Lines && (window->DrawList->Flags & ImDrawListFlags_DecimateLines) && values_count > res_w + 1)
         {
-            const float t1 = t0 + t_step;
-            const int v1_idx = (int)(t0 * item_count + 0.5f);
-            IM_ASSERT(v1_idx >= 0 && v1_idx < values_count);
-            const float v1 = values_getter(data, (v1_idx + values_offset + 1) % values_count);
-            const ImVec2 tp1 = ImVec2( t1, 1.0f - ImSaturate((v1 - scale_min) * inv_scale) );
-
-            // NB: Draw calls are merged together by the DrawList system. Still, we should render our batch are lower level to save a bit of CPU.
-            ImVec2 pos0 = ImLerp(inner_bb.Min, inner_bb.Max, tp0);
-            ImVec2 pos1 = ImLerp(inner_bb.Min, inner_bb.Max, (plot_type == ImGuiPlotType_Lines) ? tp1 : ImVec2(tp1.x, histogram_zero_line_t));
-            if (plot_type == ImGuiPlotType_Lines)
+            // Level of detail: rather than sampling one value per pixel column, visit all of them and stroke the first, last, lowest and
+            // highest values of each column as a single polyline, so peaks between samples are not lost. Same as AddLine(), at pixel centers.
+            const int columns_count = res_w + 1;
+            const float inv_item_count = 1.0f / (float)item_count;
+            ImDrawList* draw_list = window->DrawList;
+            for (int n = 0; n < columns_count; n++)
             {
-                window->DrawList->AddLine(pos0, pos1, v_hovered == v1_idx ? col_hovered : col_base);
+                const int i_first = (int)((ImS64)n * values_count / columns_count);
+                const int i_last = (int)((ImS64)(n + 1) * values_count / columns_count) - 1;
+                int i_low = i_first, i_high = i_first;
+                float v_low = values_getter(data, (i_first + values_offset) % values_count), v_high = v_low;
+                for (int i = i_first + 1; i <= i_last; i++)
+                {
+                    const float v = values_getter(data, (i + values_offset) % values_count);
+                    if (v < v_low) { v_low = v; i_low = i; }
+                    if (v > v_high) { v_high = v; i_high = i; }
+                }
+                int column_idx[4];
+                int column_idx_count = 0;
+                column_idx[column_idx_count++] = i_first;
+                if (ImMin(i_low, i_high) != i_first && ImMin(i_low, i_high) != i_last)
+                    column_idx[column_idx_count++] = ImMin(i_low, i_high);
+                if (i_low != i_high && ImMax(i_low, i_high) != i_first && ImMax(i_low, i_high) != i_last)
+                    column_idx[column_idx_count++] = ImMax(i_low, i_high);
+                if (i_last != i_first)
+                    column_idx[column_idx_count++] = i_last;
+                for (int k = 0; k < column_idx_count; k++)
+                {
+                    const int i = column_idx[k];
+                    const float v = (i == i_low) ? v_low : (i == i_high) ? v_high : values_getter(data, (i + values_offset) % values_count);
+                    const ImVec2 tp = ImVec2(i * inv_item_count, 1.0f - ImSaturate((v - scale_min) * inv_scale));
+                    draw_list->PathLineTo(ImLerp(inner_bb.Min, inner_bb.Max, tp) + ImVec2(0.5f, 0.5f));
+                }
             }
-            else if (plot_type == ImGuiPlotType_Histogram)
+            draw_list->PathStroke(col_base, false);
+            if (v_hovered >= 0)
             {
-                if (pos1.x >= pos0.x + 2.0f)
-                    pos1.x -= 1.0f;
-                window->DrawList->AddRectFilled(pos0, pos1, v_hovered == v1_idx ? col_hovered : col_base);
+                const float vh0 = values_getter(data, (v_hovered + values_offset) % values_count);
+                const float vh1 = values_getter(data, (v_hovered + 1 + values_offset) % values_count);
+                const ImVec2 pos0 = ImLerp(inner_bb.Min, inner_bb.Max, ImVec2(v_hovered * inv_item_count, 1.0f - ImSaturate((vh0 - scale_min) * inv_scale)));
+                const ImVec2 pos1 = ImLerp(inner_bb.Min, inner_bb.Max, ImVec2((v_hovered + 1) * inv_item_count, 1.0f - ImSaturate((vh1 - scale_min) * inv_scale)));
+                draw_list->AddLine(pos0, pos1, col_hovered);
             }
+        }
+        else
+        {
+            for (int n = 0; n < res_w; n++)
+            {
+                const float t1 = t0 + t_step;
+                const int v1_idx = (int)(t0 * item_count + 0.5f);
+                IM_ASSERT(v1_idx >= 0 && v1_idx < values_count);
+                const float v1 = values_getter(data, (v1_idx + values_offset + 1) % values_count);
+                const ImVec2 tp1 = ImVec2( t1, 1.0f - ImSaturate((v1 - scale_min) * inv_scale) );
+
+                // NB: Draw calls are merged together by the DrawList system. Still, we should render our batch are lower level to save a bit of CPU.
+                ImVec2 pos0 = ImLerp(inner_bb.Min, inner_bb.Max, tp0);
+                ImVec2 pos1 = ImLerp(inner_bb.Min, inner_bb.Max, (plot_type == ImGuiPlotType_Lines) ? tp1 : ImVec2(tp1.x, histogram_zero_line_t));
+                if (plot_type == ImGuiPlotType_Lines)
+                {
+                    window->DrawList->AddLine(pos0, pos1, v_hovered == v1_idx ? col_hovered : col_base);
+                }
+                else if (plot_type == ImGuiPlotType_Histogram)
+                {
+                    if (pos1.x >= pos0.x + 2.0f)
+                        pos1.x -= 1.0f;
+                    window->DrawList->AddRectFilled(pos0, pos1, v_hovered == v1_idx ? col_hovered : col_base);
+                }
 
-            t0 = t1;
-            tp0 = tp1;
+                t0 = t1;
+                tp0 = tp1;
+            }
         }
     }
 